@@ -0,0 +1,395 @@
+// 基准测试：覆盖各工具的全部大整数内核
+// 编译：g++ -std=c++17 -O2 benchmark.cpp -o benchmark.exe
+// 用法：benchmark.exe [--format json|csv] [--out 文件] [--seed N] [--min-digits N] [--max-digits N]
+//                     [--budget-ms N] [--min-time-ms N] [--filter 子串]
+// 输入由固定种子生成，同一种子在不同版本间得到相同的数据，便于对比回归和检查算法切换阈值。
+// 规模从 min-digits 到 max-digits 按 10^(k/2) 递增；某个内核按已测得的增长率预测下一个规模
+// 单次耗时超过 budget-ms 时，剩余规模记为 skipped，避免平方/立方级算法卡死整个测试。
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <random>
+#include <chrono>
+#include <regex>
+#include <stdexcept>
+#include <cmath>
+#include <numeric>
+#include <cstring>
+#include <climits>
+#include <charconv>
+#include <cctype>
+#include <cstdint>
+#include <stdlib.h>
+#include "bigint.h"
+#include "bigbin.h"
+#include "primetable.h"
+
+// 每个工具都是独立的单文件程序（各有 main，函数名也可能互相冲突），
+// 这里把它们分别包进独立命名空间，直接测量工具层的实现；标准头文件、bigint.h 和 bigbin.h 已在上面包含，重复包含会被跳过
+namespace hp_tool {
+#define main hp_tool_main
+#include "High_Precision.cpp"
+#undef main
+}
+
+namespace prime_tool {
+#define main prime_tool_main
+#include "prime.cpp"
+#undef main
+}
+
+namespace frac_tool {
+#define main frac_tool_main
+#include "Fraction.cpp"
+#undef main
+}
+
+namespace conv_tool {
+#define main conv_tool_main
+#include "High-Precision_Base_Converter.cpp"
+#undef main
+}
+
+using namespace std;
+using hpcore::BigUInt;
+
+// ==================== 参数 ====================
+
+struct BenchOptions {
+	string format = "json";
+	string out_path;
+	uint64_t seed = 20240601;
+	long long min_digits = 10;
+	long long max_digits = 1000000;
+	double budget_ms = 2000;
+	double min_time_ms = 100;
+	string filter;
+};
+
+// ==================== 输入生成 ====================
+
+// 每个 (内核, 规模) 使用独立派生的种子，结果与 --filter 的选择无关
+uint64_t derive_seed(uint64_t seed, const string& name, long long digits) {
+	uint64_t h = seed ^ 0x9E3779B97F4A7C15ULL;
+	for (char c : name) h = (h ^ (unsigned char)c) * 0x100000001B3ULL;
+	h ^= (uint64_t)digits * 0xBF58476D1CE4E5B9ULL;
+	h ^= h >> 31;
+	return h;
+}
+
+// 指定位数的随机十进制数（首位不为0）
+string random_digits(mt19937_64& gen, long long digits) {
+	string s;
+	s.reserve(digits);
+	s.push_back('1' + gen() % 9);
+	for (long long i = 1; i < digits; i++) s.push_back('0' + gen() % 10);
+	return s;
+}
+
+// 随机奇数（用于素性测试的合数输入）
+string random_odd(mt19937_64& gen, long long digits) {
+	string s = random_digits(gen, digits);
+	if ((s.back() - '0') % 2 == 0) s.back() += 1;
+	return s;
+}
+
+// 2^p - 1（只在实际要测试该规模时才计算）
+BigUInt mersenne(long long p) {
+	return (BigUInt(1) << p) - BigUInt(1);
+}
+
+// 位数不超过 digits 的最大梅森素数的指数
+long long mersenne_exponent_for(long long digits) {
+	static const long long exps[] = {
+		2, 3, 5, 7, 13, 17, 19, 31, 61, 89, 107, 127, 521, 607, 1279, 2203, 2281, 3217, 4253, 4423,
+		9689, 9941, 11213, 19937, 21701, 23209, 44497, 86243, 110503, 132049, 216091, 756839,
+		859433, 1257787, 1398269, 2976221, 3021377
+	};
+	long long best = 2;
+	for (long long p : exps) {
+		if ((long long)(p * log10(2.0)) + 1 <= digits) best = p;
+	}
+	return best;
+}
+
+// ==================== 测试用例 ====================
+
+// 防止结果被优化掉
+volatile size_t g_sink = 0;
+
+struct BenchCase {
+	string impl;    // 实现（工具）名
+	string kernel;  // 内核名
+	// 根据随机源和规模准备输入，返回一个可重复执行的操作
+	function<function<void()>(mt19937_64&, long long)> prepare;
+};
+
+vector<BenchCase> build_cases() {
+	vector<BenchCase> cases;
+
+	// ---------- bigint.h：共享核心（所有工具都经由它运算）----------
+	auto core_binary = [&](const string& kernel, function<size_t(const BigUInt&, const BigUInt&)> op, bool wide) {
+		cases.push_back({"core", kernel, [op, wide](mt19937_64& gen, long long d) {
+			// 除法类内核用 2d 位除以 d 位
+			BigUInt a(random_digits(gen, wide ? 2 * d : d)), b(random_digits(gen, d));
+			if (a < b) swap(a, b);
+			return function<void()>([a, b, op]() { g_sink += op(a, b); });
+		}});
+	};
+	core_binary("add", [](const BigUInt& a, const BigUInt& b) { return (a + b).size(); }, false);
+	core_binary("sub", [](const BigUInt& a, const BigUInt& b) { return (a - b).size(); }, false);
+	core_binary("mul", [](const BigUInt& a, const BigUInt& b) { return (a * b).size(); }, false);
+	core_binary("sqr", [](const BigUInt& a, const BigUInt&) { return a.sqr().size(); }, false);
+	core_binary("divmod", [](const BigUInt& a, const BigUInt& b) { return (a % b).size(); }, true);
+	core_binary("gcd", [](const BigUInt& a, const BigUInt& b) { return BigUInt::gcd(a, b).size(); }, false);
+	cases.push_back({"core", "from_decimal", [](mt19937_64& gen, long long d) {
+		string s = random_digits(gen, d);
+		return function<void()>([s]() { g_sink += BigUInt(s).size(); });
+	}});
+	cases.push_back({"core", "to_decimal", [](mt19937_64& gen, long long d) {
+		BigUInt a(random_digits(gen, d));
+		return function<void()>([a]() { g_sink += a.to_string().size(); });
+	}});
+
+	// ---------- High_Precision.cpp：Fraction ----------
+	// 有限小数展开：随机分子 / 2^d，小数部分恰好 d 位
+	cases.push_back({"high_precision", "fraction_to_decimal", [](mt19937_64& gen, long long d) {
+		hp_tool::Fraction f(1, BigUInt(random_odd(gen, max<long long>(1, d * 3 / 10))), BigUInt(1) << d);
+		return function<void()>([f]() { g_sink += f.toDecimalString().size(); });
+	}});
+
+	// ---------- prime.cpp ----------
+	cases.push_back({"prime", "multiply_mod", [](mt19937_64& gen, long long d) {
+		BigUInt n(random_odd(gen, d)), a(random_digits(gen, max<long long>(1, d - 1))), b(random_digits(gen, max<long long>(1, d - 1)));
+		return function<void()>([a, b, n]() { g_sink += prime_tool::multiply_mod(a, b, n).size(); });
+	}});
+	cases.push_back({"prime", "power_mod", [](mt19937_64& gen, long long d) {
+		BigUInt n(random_odd(gen, d)), a(random_digits(gen, max<long long>(1, d - 1))), e(random_digits(gen, d));
+		return function<void()>([a, e, n]() { g_sink += prime_tool::power_mod(a, e, n).size(); });
+	}});
+	// 素数输入会跑满所有基，用不超过该位数的最大梅森素数
+	cases.push_back({"prime", "miller_rabin_prime", [](mt19937_64&, long long d) {
+		BigUInt n = mersenne(mersenne_exponent_for(d));
+		return function<void()>([n]() { g_sink += prime_tool::miller_rabin(n); });
+	}});
+	cases.push_back({"prime", "miller_rabin_composite", [](mt19937_64& gen, long long d) {
+		BigUInt n(random_odd(gen, d));
+		return function<void()>([n]() { g_sink += prime_tool::miller_rabin(n); });
+	}});
+	// 默认判定（64位以上为 Baillie-PSW）
+	cases.push_back({"prime", "bpsw_prime", [](mt19937_64&, long long d) {
+		BigUInt n = mersenne(mersenne_exponent_for(d));
+		return function<void()>([n]() { g_sink += prime_tool::is_prime(n); });
+	}});
+	cases.push_back({"prime", "bpsw_composite", [](mt19937_64& gen, long long d) {
+		BigUInt n(random_odd(gen, d));
+		return function<void()>([n]() { g_sink += prime_tool::is_prime(n); });
+	}});
+	// 随机质数生成：用派生种子重置工具里的全局随机数，每次调用生成一个新质数
+	cases.push_back({"prime", "random_prime", [](mt19937_64& gen, long long d) {
+		prime_tool::rng.seed((uint32_t)gen());
+		return function<void()>([d]() { g_sink += prime_tool::generate_random_prime((int)d).size(); });
+	}});
+
+	// ---------- Fraction.cpp ----------
+	// 循环小数展开：分母取 10^d - 1，循环节长度为 d
+	cases.push_back({"fraction", "fraction_to_decimal", [](mt19937_64& gen, long long d) {
+		string den(d, '9'), num = random_digits(gen, max<long long>(1, d - 1));
+		return function<void()>([num, den]() { g_sink += frac_tool::expandFraction(num, den).size(); });
+	}});
+
+	// ---------- High-Precision_Base_Converter.cpp ----------
+	// 整数部分：十进制 -> 十六进制
+	cases.push_back({"base_converter", "int_base10_to_16", [](mt19937_64& gen, long long d) {
+		string s = random_digits(gen, d);
+		return function<void()>([s]() {
+			g_sink += conv_tool::int_to_dest_base(conv_tool::src_base_to_int(s, 10), 16).size();
+		});
+	}});
+	// 整数部分：十进制 -> 七进制（非2的幂，走分治除法）
+	cases.push_back({"base_converter", "int_base10_to_7", [](mt19937_64& gen, long long d) {
+		string s = random_digits(gen, d);
+		return function<void()>([s]() {
+			g_sink += conv_tool::int_to_dest_base(conv_tool::src_base_to_int(s, 10), 7).size();
+		});
+	}});
+	// 小数部分：d 位十进制小数 -> 二进制（工具固定输出最多100位）
+	cases.push_back({"base_converter", "frac_base10_to_2", [](mt19937_64& gen, long long d) {
+		string s = random_digits(gen, d);
+		return function<void()>([s]() { g_sink += conv_tool::convert_fraction_part(s, 10, 2).size(); });
+	}});
+
+	return cases;
+}
+
+// ==================== 计时 ====================
+
+struct BenchResult {
+	string impl;
+	string kernel;
+	long long digits;
+	long long iterations;
+	double ns_per_op;
+	string status;
+};
+
+double now_ns() {
+	return (double)chrono::duration_cast<chrono::nanoseconds>(
+		chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// 反复执行直到累计时间达到 min_time_ms，返回每次耗时（纳秒）
+pair<long long, double> run_timed(const function<void()>& op, double min_time_ms) {
+	long long iterations = 0;
+	double start = now_ns(), elapsed = 0;
+	do {
+		op();
+		iterations++;
+		elapsed = now_ns() - start;
+	} while (elapsed < min_time_ms * 1e6);
+	return {iterations, elapsed / iterations};
+}
+
+vector<long long> size_grid(long long lo, long long hi) {
+	vector<long long> sizes;
+	for (int k = 0; k <= 12; k++) {
+		long long d = (long long)llround(pow(10.0, k / 2.0));
+		if (d >= lo && d <= hi && (sizes.empty() || sizes.back() != d)) sizes.push_back(d);
+	}
+	return sizes;
+}
+
+// ==================== 输出 ====================
+
+string json_escape(const string& s) {
+	string r;
+	for (char c : s) {
+		if (c == '"' || c == '\\') r.push_back('\\');
+		r.push_back(c);
+	}
+	return r;
+}
+
+void write_results(ostream& out, const BenchOptions& opt, const vector<BenchResult>& results) {
+	if (opt.format == "csv") {
+		out << "impl,kernel,digits,iterations,ns_per_op,status\n";
+		for (const auto& r : results) {
+			out << r.impl << "," << r.kernel << "," << r.digits << "," << r.iterations << ","
+				<< fixed << r.ns_per_op << "," << r.status << "\n";
+		}
+		return;
+	}
+	out << "{\n  \"seed\": " << opt.seed << ",\n  \"budget_ms\": " << opt.budget_ms
+		<< ",\n  \"results\": [\n";
+	for (size_t i = 0; i < results.size(); i++) {
+		const auto& r = results[i];
+		out << "    {\"impl\": \"" << json_escape(r.impl) << "\", \"kernel\": \"" << json_escape(r.kernel)
+			<< "\", \"digits\": " << r.digits << ", \"iterations\": " << r.iterations
+			<< ", \"ns_per_op\": " << fixed << r.ns_per_op << ", \"status\": \"" << r.status << "\"}"
+			<< (i + 1 < results.size() ? "," : "") << "\n";
+	}
+	out << "  ]\n}\n";
+}
+
+// ==================== 主函数 ====================
+
+int main(int argc, char* argv[]) {
+	BenchOptions opt;
+	for (int i = 1; i < argc; i++) {
+		string arg = argv[i];
+		auto next = [&]() -> string {
+			if (i + 1 >= argc) {
+				cerr << "参数 " << arg << " 缺少取值" << endl;
+				exit(1);
+			}
+			return argv[++i];
+		};
+		try {
+			if (arg == "--format") opt.format = next();
+			else if (arg == "--out") opt.out_path = next();
+			else if (arg == "--seed") opt.seed = stoull(next());
+			else if (arg == "--min-digits") opt.min_digits = stoll(next());
+			else if (arg == "--max-digits") opt.max_digits = stoll(next());
+			else if (arg == "--budget-ms") opt.budget_ms = stod(next());
+			else if (arg == "--min-time-ms") opt.min_time_ms = stod(next());
+			else if (arg == "--filter") opt.filter = next();
+			else {
+				cerr << "未知参数：" << arg << endl;
+				return 1;
+			}
+		} catch (const exception&) {
+			cerr << "参数 " << arg << " 的取值无效" << endl;
+			return 1;
+		}
+	}
+	if (opt.format != "json" && opt.format != "csv") {
+		cerr << "输出格式只能是 json 或 csv" << endl;
+		return 1;
+	}
+
+	vector<long long> sizes = size_grid(opt.min_digits, opt.max_digits);
+	vector<BenchResult> results;
+
+	for (const auto& c : build_cases()) {
+		string name = c.impl + "." + c.kernel;
+		if (!opt.filter.empty() && name.find(opt.filter) == string::npos) continue;
+
+		// 用最近两个规模的耗时估计增长指数，预测下一个规模是否超出预算
+		double prev_ns = 0, last_ns = 0;
+		long long prev_d = 0, last_d = 0;
+		bool skipping = false;
+		for (long long d : sizes) {
+			if (!skipping && last_d > 0) {
+				double exponent = 2.0;
+				if (prev_d > 0 && prev_ns > 0) {
+					exponent = log(last_ns / prev_ns) / log((double)last_d / prev_d);
+					exponent = max(1.0, exponent);
+				}
+				double predicted = last_ns * pow((double)d / last_d, exponent);
+				if (predicted > opt.budget_ms * 1e6) skipping = true;
+			}
+			if (skipping) {
+				results.push_back({c.impl, c.kernel, d, 0, 0, "skipped"});
+				continue;
+			}
+
+			cerr << name << " @ " << d << " 位 ..." << flush;
+			mt19937_64 gen(derive_seed(opt.seed, name, d));
+			function<void()> op = c.prepare(gen, d);
+			auto [iterations, ns] = run_timed(op, opt.min_time_ms);
+			cerr << " " << ns / 1e6 << " ms/次" << endl;
+			results.push_back({c.impl, c.kernel, d, iterations, ns, "ok"});
+
+			prev_ns = last_ns;
+			prev_d = last_d;
+			last_ns = ns;
+			last_d = d;
+			if (ns > opt.budget_ms * 1e6) skipping = true;
+		}
+	}
+
+	if (opt.out_path.empty()) {
+		write_results(cout, opt, results);
+	} else {
+		ofstream out(opt.out_path);
+		if (!out) {
+			cerr << "无法写入文件：" << opt.out_path << endl;
+			return 1;
+		}
+		write_results(out, opt, results);
+	}
+	return 0;
+}
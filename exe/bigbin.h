@@ -0,0 +1,442 @@
+// 大整数/分数的紧凑二进制格式（.hpbn），让各工具之间传递数据时不必反复做十进制转换
+//
+// 文件头（16字节）：
+//   magic "HPBN" | u16 版本号(=1) | u16 文件头长度(=16) | u64 保留(=0)
+// 记录（整条记录长度是8的倍数，映射到内存后limb按8字节对齐）：
+//   整数：u8 类型(=1) | u8 符号(0正 1负) | u16 保留 | u32 limb数n | n个u64 limb（小端，低位在前）
+//   分数：u8 类型(=2) | u8 符号 | u16 保留 | u32 分子limb数 | u32 分母limb数 | u32 保留 | 分子limb | 分母limb
+// 所有整数字段均为小端。写入端流式输出、不需要预先知道记录数；读取端既可流式读取，
+// 也可用 MappedHpbn 把整个文件映射到内存，直接在映射区上访问 limb，不做任何拷贝。
+#ifndef HP_BIGBIN_H
+#define HP_BIGBIN_H
+
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <iostream>
+#include <fstream>
+#include <stdexcept>
+#include "bigint.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <io.h>
+#include <fcntl.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "hpbn 的零拷贝读取要求小端平台"
+#endif
+
+namespace hpcore {
+
+const char HPBN_MAGIC[4] = {'H', 'P', 'B', 'N'};
+const uint16_t HPBN_VERSION = 1;
+const uint16_t HPBN_HEADER_SIZE = 16;
+
+enum HpbnKind : uint8_t {
+	HPBN_INTEGER = 1,
+	HPBN_FRACTION = 2
+};
+
+// 流式读取得到的一条记录（整数记录的 den 为1）
+struct HpbnRecord {
+	HpbnKind kind = HPBN_INTEGER;
+	int sign = 1;
+	BigUInt num;
+	BigUInt den = BigUInt(1);
+};
+
+// 把标准输入输出切换到二进制模式（Windows 下默认会转换换行符）
+inline void hpbn_set_binary_stdio() {
+#ifdef _WIN32
+	_setmode(_fileno(stdin), _O_BINARY);
+	_setmode(_fileno(stdout), _O_BINARY);
+#endif
+}
+
+// ==================== 写入 ====================
+
+class HpbnWriter {
+private:
+	std::ostream& out;
+	uint64_t count = 0;
+
+	void put_u32(uint32_t v) {
+		unsigned char b[4] = {(unsigned char)v, (unsigned char)(v >> 8), (unsigned char)(v >> 16), (unsigned char)(v >> 24)};
+		out.write((const char*)b, 4);
+	}
+
+	void put_limbs(const BigUInt& x) {
+		// 小端平台上内存布局即文件布局
+		out.write((const char*)x.limb_vector().data(), x.size() * sizeof(limb_t));
+	}
+
+	static uint32_t limb_count(const BigUInt& x) {
+		if (x.size() > UINT32_MAX) throw std::length_error("整数过大，无法写入 hpbn 记录");
+		return (uint32_t)x.size();
+	}
+
+public:
+	explicit HpbnWriter(std::ostream& os) : out(os) {
+		char header[HPBN_HEADER_SIZE] = {};
+		memcpy(header, HPBN_MAGIC, 4);
+		header[4] = (char)(HPBN_VERSION & 0xFF);
+		header[5] = (char)(HPBN_VERSION >> 8);
+		header[6] = (char)(HPBN_HEADER_SIZE & 0xFF);
+		header[7] = (char)(HPBN_HEADER_SIZE >> 8);
+		out.write(header, sizeof(header));
+	}
+
+	void write_integer(const BigUInt& x, int sign = 1) {
+		out.put((char)HPBN_INTEGER);
+		out.put((char)(sign < 0 && !x.is_zero() ? 1 : 0));
+		out.put(0);
+		out.put(0);
+		put_u32(limb_count(x));
+		put_limbs(x);
+		count++;
+	}
+
+	void write_fraction(const Rational& r) {
+		out.put((char)HPBN_FRACTION);
+		out.put((char)(r.sign() < 0 ? 1 : 0));
+		out.put(0);
+		out.put(0);
+		put_u32(limb_count(r.num()));
+		put_u32(limb_count(r.den()));
+		put_u32(0);
+		put_limbs(r.num());
+		put_limbs(r.den());
+		count++;
+	}
+
+	void write(const HpbnRecord& rec) {
+		if (rec.kind == HPBN_INTEGER) {
+			write_integer(rec.num, rec.sign);
+		} else {
+			write_fraction(Rational(rec.sign, rec.num, rec.den));
+		}
+	}
+
+	uint64_t records_written() const { return count; }
+	bool good() const { return out.good(); }
+
+	// 写完最后一条记录后调用：刷新输出并检查流状态，磁盘写满等错误在这里抛出，而不是留下一个被截断的文件
+	void finish() {
+		out.flush();
+		if (!out) throw std::runtime_error("写入 hpbn 输出失败（磁盘已满或输出已关闭）");
+	}
+};
+
+// ==================== 流式读取 ====================
+
+inline void hpbn_check_header(const unsigned char* h) {
+	if (memcmp(h, HPBN_MAGIC, 4) != 0) throw std::runtime_error("不是 hpbn 文件（魔数不匹配）");
+	uint16_t version = h[4] | (h[5] << 8);
+	uint16_t header_size = h[6] | (h[7] << 8);
+	if (version != HPBN_VERSION) throw std::runtime_error("不支持的 hpbn 版本：" + std::to_string(version));
+	if (header_size != HPBN_HEADER_SIZE) throw std::runtime_error("hpbn 文件头长度无效");
+}
+
+inline uint32_t hpbn_get_u32(const unsigned char* p) {
+	return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// 一条记录的只读视图：num/den 直接指向映射内存（或 HpbnReader 的缓冲区），需要运算时再复制成 BigUInt
+struct HpbnView {
+	HpbnKind kind;
+	int sign;
+	const limb_t* num;
+	size_t num_size;
+	const limb_t* den;  // 整数记录为 nullptr
+	size_t den_size;
+
+	BigUInt num_value() const { return BigUInt::from_limbs(std::vector<limb_t>(num, num + num_size)); }
+	BigUInt den_value() const {
+		return den ? BigUInt::from_limbs(std::vector<limb_t>(den, den + den_size)) : BigUInt(1);
+	}
+	// 分子是否为偶数（不复制）
+	bool num_is_even() const { return num_size == 0 || (num[0] & 1) == 0; }
+};
+
+inline bool hpbn_limbs_zero(const limb_t* p, size_t n) {
+	for (size_t i = 0; i < n; i++) {
+		if (p[i]) return false;
+	}
+	return true;
+}
+
+// 由记录头 h 和紧随其后的 limb 填写视图，并做与 HpbnReader 相同的检查：分母不能为0，0 的符号取正
+inline void hpbn_fill_view(HpbnView& v, const unsigned char* h, const limb_t* body, size_t num_n, size_t den_n) {
+	v.kind = (HpbnKind)h[0];
+	v.sign = h[1] ? -1 : 1;
+	v.num = body;
+	v.num_size = num_n;
+	v.den = v.kind == HPBN_INTEGER ? nullptr : body + num_n;
+	v.den_size = den_n;
+	if (v.kind == HPBN_FRACTION && hpbn_limbs_zero(v.den, den_n)) throw std::runtime_error("hpbn 分数记录的分母为0");
+	if (hpbn_limbs_zero(v.num, num_n)) v.sign = 1;
+}
+
+// 流式读取时每次最多按这么多 limb 扩充缓冲区：记录头里的 limb 数不可信，先读到数据再扩容，
+// 被截断或伪造的记录不会让读取端一次分配几十 GiB 内存
+const size_t HPBN_READ_CHUNK_LIMBS = 1 << 16;
+
+class HpbnReader {
+private:
+	std::istream& in;
+	uint64_t left = UINT64_MAX;   // 可定位的输入（文件）还剩多少字节；管道等无法定位时为 UINT64_MAX
+
+	void read_bytes(void* out, size_t n) {
+		in.read((char*)out, (std::streamsize)n);
+		if (!in) throw std::runtime_error("hpbn 记录被截断");
+		if (left != UINT64_MAX) left -= n;
+	}
+
+	// 读取 n 个 limb 追加到 v 末尾：先用剩余长度挡掉明显超长的记录，再分块扩容、分块读取
+	void read_limbs_into(std::vector<limb_t>& v, size_t n) {
+		if (left != UINT64_MAX && n > left / sizeof(limb_t)) throw std::runtime_error("hpbn 记录被截断");
+		while (n > 0) {
+			size_t m = std::min(n, HPBN_READ_CHUNK_LIMBS);
+			size_t old = v.size();
+			v.resize(old + m);
+			read_bytes(v.data() + old, m * sizeof(limb_t));
+			n -= m;
+		}
+	}
+
+	BigUInt read_limbs(uint32_t n) {
+		std::vector<limb_t> v;
+		read_limbs_into(v, n);
+		return BigUInt::from_limbs(std::move(v));
+	}
+
+	std::vector<limb_t> buffer;   // next(HpbnView&) 读出的 limb，下一次调用前有效
+
+	// 读记录头的前8字节，文件正好在记录边界结束时返回 false
+	bool read_record_header(unsigned char* h) {
+		in.read((char*)h, 8);
+		if (in.gcount() == 0 && in.eof()) return false;
+		if (!in) throw std::runtime_error("hpbn 记录被截断");
+		if (left != UINT64_MAX) left -= 8;
+		if (h[0] != HPBN_INTEGER && h[0] != HPBN_FRACTION) throw std::runtime_error("未知的 hpbn 记录类型");
+		return true;
+	}
+
+public:
+	explicit HpbnReader(std::istream& is) : in(is) {
+		unsigned char header[HPBN_HEADER_SIZE];
+		in.read((char*)header, sizeof(header));
+		if (!in) throw std::runtime_error("hpbn 文件头不完整");
+		hpbn_check_header(header);
+		// 能定位的输入先量出剩余长度，用来在分配前检查记录头里的 limb 数
+		std::streampos pos = in.tellg();
+		if (pos != std::streampos(-1) && in.seekg(0, std::ios::end)) {
+			std::streampos end = in.tellg();
+			in.seekg(pos);
+			if (end != std::streampos(-1) && in && end >= pos) left = (uint64_t)(end - pos);
+		}
+		in.clear();
+	}
+
+	// 读取下一条记录，文件结束时返回 false
+	bool next(HpbnRecord& rec) {
+		unsigned char h[8];
+		if (!read_record_header(h)) return false;
+		rec.kind = (HpbnKind)h[0];
+		rec.sign = h[1] ? -1 : 1;
+		if (rec.kind == HPBN_INTEGER) {
+			rec.num = read_limbs(hpbn_get_u32(h + 4));
+			rec.den = BigUInt(1);
+		} else {
+			unsigned char h2[8];
+			read_bytes(h2, 8);
+			uint32_t num_n = hpbn_get_u32(h + 4), den_n = hpbn_get_u32(h2);
+			rec.num = read_limbs(num_n);
+			rec.den = read_limbs(den_n);
+			if (rec.den.is_zero()) throw std::runtime_error("hpbn 分数记录的分母为0");
+		}
+		if (rec.num.is_zero()) rec.sign = 1;
+		return true;
+	}
+
+	// 读取下一条记录到内部缓冲区，v 指向缓冲区（下一次调用前有效），文件结束时返回 false
+	bool next(HpbnView& v) {
+		unsigned char h[16];
+		if (!read_record_header(h)) return false;
+		if (h[0] == HPBN_FRACTION) read_bytes(h + 8, 8);
+		size_t num_n = hpbn_get_u32(h + 4), den_n = h[0] == HPBN_FRACTION ? hpbn_get_u32(h + 8) : 0;
+		buffer.clear();
+		read_limbs_into(buffer, num_n + den_n);
+		hpbn_fill_view(v, h, buffer.data(), num_n, den_n);
+		return true;
+	}
+};
+
+// ==================== 内存映射零拷贝读取 ====================
+
+// 只读映射整个文件（空文件也可打开，此时 data() 为 nullptr）；多个进程映射同一文件时共享页缓存
+class MappedFile {
+private:
+	const unsigned char* base = nullptr;
+	size_t length = 0;
+#ifdef _WIN32
+	HANDLE file = INVALID_HANDLE_VALUE;
+	HANDLE mapping = NULL;
+#else
+	int fd = -1;
+#endif
+
+	void close_all() {
+#ifdef _WIN32
+		if (base) UnmapViewOfFile(base);
+		if (mapping) CloseHandle(mapping);
+		if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+		mapping = NULL;
+		file = INVALID_HANDLE_VALUE;
+#else
+		if (base) munmap((void*)base, length);
+		if (fd >= 0) close(fd);
+		fd = -1;
+#endif
+		base = nullptr;
+		length = 0;
+	}
+
+public:
+	explicit MappedFile(const std::string& path) {
+#ifdef _WIN32
+		file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+		if (file == INVALID_HANDLE_VALUE) throw std::runtime_error("无法打开文件：" + path);
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(file, &size)) {
+			close_all();
+			throw std::runtime_error("无法读取文件大小：" + path);
+		}
+		length = (size_t)size.QuadPart;
+		if (length > 0) {
+			mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+			if (mapping) base = (const unsigned char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		}
+#else
+		fd = open(path.c_str(), O_RDONLY);
+		if (fd < 0) throw std::runtime_error("无法打开文件：" + path);
+		struct stat st;
+		if (fstat(fd, &st) != 0) {
+			close_all();
+			throw std::runtime_error("无法读取文件大小：" + path);
+		}
+		length = (size_t)st.st_size;
+		if (length > 0) {
+			void* p = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+			base = p == MAP_FAILED ? nullptr : (const unsigned char*)p;
+		}
+#endif
+		if (length > 0 && !base) {
+			close_all();
+			throw std::runtime_error("无法映射文件：" + path);
+		}
+	}
+
+	~MappedFile() { close_all(); }
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	const unsigned char* data() const { return base; }
+	size_t size() const { return length; }
+};
+
+class MappedHpbn {
+private:
+	MappedFile file;
+
+public:
+	explicit MappedHpbn(const std::string& path) : file(path) {
+		if (file.size() < HPBN_HEADER_SIZE) throw std::runtime_error("hpbn 文件头不完整");
+		hpbn_check_header(file.data());
+	}
+
+	MappedHpbn(const MappedHpbn&) = delete;
+	MappedHpbn& operator=(const MappedHpbn&) = delete;
+
+	// 顺序遍历记录的游标
+	class Cursor {
+	private:
+		const unsigned char* p;
+		const unsigned char* end;
+
+	public:
+		Cursor(const unsigned char* begin, const unsigned char* e) : p(begin), end(e) {}
+
+		bool next(HpbnView& v) {
+			if (p == end) return false;
+			if (end - p < 8) throw std::runtime_error("hpbn 记录被截断");
+			if (p[0] != HPBN_INTEGER && p[0] != HPBN_FRACTION) throw std::runtime_error("未知的 hpbn 记录类型");
+			size_t header = p[0] == HPBN_INTEGER ? 8 : 16;
+			if ((size_t)(end - p) < header) throw std::runtime_error("hpbn 记录被截断");
+			size_t num_n = hpbn_get_u32(p + 4), den_n = p[0] == HPBN_INTEGER ? 0 : hpbn_get_u32(p + 8);
+			size_t body = (num_n + den_n) * sizeof(limb_t);
+			if ((size_t)(end - p) - header < body) throw std::runtime_error("hpbn 记录被截断");
+			hpbn_fill_view(v, p, (const limb_t*)(p + header), num_n, den_n);
+			p += header + body;
+			return true;
+		}
+	};
+
+	Cursor records() const { return Cursor(file.data() + HPBN_HEADER_SIZE, file.data() + file.size()); }
+};
+
+// ==================== 批处理辅助 ====================
+
+// 依次把文件中的每条记录以 HpbnView 交给 callback："-" 表示从标准输入流式读取（视图指向读缓冲区），
+// 否则映射文件，视图直接指向映射区，记录不经复制；回调只在需要运算时才用 num_value()/den_value() 取出 BigUInt
+template <class F>
+void hpbn_for_each(const std::string& path, F callback) {
+	HpbnView view;
+	if (path == "-") {
+		hpbn_set_binary_stdio();
+		HpbnReader reader(std::cin);
+		while (reader.next(view)) callback(view);
+		return;
+	}
+	MappedHpbn mapped(path);
+	MappedHpbn::Cursor cursor = mapped.records();
+	while (cursor.next(view)) callback(view);
+}
+
+// 打开输出流："-" 表示标准输出
+class HpbnOutput {
+private:
+	std::ofstream file;
+	std::ostream* os;
+
+public:
+	explicit HpbnOutput(const std::string& path) : os(&std::cout) {
+		if (path != "-") {
+			file.open(path, std::ios::binary);
+			if (!file) throw std::runtime_error("无法写入文件：" + path);
+			os = &file;
+		} else {
+			hpbn_set_binary_stdio();
+		}
+	}
+
+	std::ostream& stream() { return *os; }
+};
+
+}  // namespace hpcore
+
+#endif
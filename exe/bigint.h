@@ -0,0 +1,1325 @@
+// 共享的高精度整数/有理数运算核心，所有数值工具共用
+// 仅头文件：各工具直接 #include "bigint.h"，单独 g++ xxx.cpp 即可编译，不需要额外链接
+// 整数以64位limb小端存储；乘法在limb数较多时切换到 Karatsuba，除法切换到 Burnikel-Ziegler 递归除法，
+// 最大公约数使用 Lehmer 算法，进制转换使用分治。切换阈值可用 benchmark.exe 校准。
+#ifndef HP_BIGINT_H
+#define HP_BIGINT_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include "profiler.h"
+
+namespace hpcore {
+
+typedef uint64_t limb_t;
+typedef unsigned __int128 dlimb_t;
+
+const int LIMB_BITS = 64;
+
+// 算法切换阈值（limb数）
+const size_t KARATSUBA_THRESHOLD = 32;
+const size_t BZ_THRESHOLD = 48;
+const size_t CONVERT_THRESHOLD = 24;
+// Montgomery 模乘在此以下按列把乘积和约简合并成一遍（乘积扫描），以上才先做 Karatsuba 乘法再单独约简
+const size_t MONT_KARATSUBA_THRESHOLD = 160;
+
+// ==================== limb 数组底层运算 ====================
+// 约定：r 可以与 a 相同（原地运算），但不能与 b 部分重叠
+
+inline int limb_clz(limb_t x) {
+	return x ? __builtin_clzll(x) : 64;
+}
+
+inline int limb_ctz(limb_t x) {
+	return x ? __builtin_ctzll(x) : 64;
+}
+
+// r = a + b（各 n 个limb），返回进位
+inline limb_t limbs_add_n(limb_t* r, const limb_t* a, const limb_t* b, size_t n) {
+	limb_t carry = 0;
+	for (size_t i = 0; i < n; i++) {
+		limb_t s = a[i] + carry;
+		carry = s < carry;
+		s += b[i];
+		carry += s < b[i];
+		r[i] = s;
+	}
+	return carry;
+}
+
+// r = a + b（a 有 n 个limb，b 是单个limb），返回进位
+inline limb_t limbs_add_1(limb_t* r, const limb_t* a, size_t n, limb_t b) {
+	for (size_t i = 0; i < n; i++) {
+		limb_t s = a[i] + b;
+		b = s < b;
+		r[i] = s;
+	}
+	return b;
+}
+
+// r = a - b（各 n 个limb），返回借位
+inline limb_t limbs_sub_n(limb_t* r, const limb_t* a, const limb_t* b, size_t n) {
+	limb_t borrow = 0;
+	for (size_t i = 0; i < n; i++) {
+		limb_t x = a[i];
+		limb_t d = x - b[i];
+		limb_t b1 = x < b[i];
+		limb_t d2 = d - borrow;
+		borrow = b1 | (d < borrow);
+		r[i] = d2;
+	}
+	return borrow;
+}
+
+// r = a - b（a 有 n 个limb，b 是单个limb），返回借位
+inline limb_t limbs_sub_1(limb_t* r, const limb_t* a, size_t n, limb_t b) {
+	for (size_t i = 0; i < n; i++) {
+		limb_t x = a[i];
+		r[i] = x - b;
+		b = x < b;
+	}
+	return b;
+}
+
+// r = a + b（an >= bn），结果 an 个limb，返回进位
+inline limb_t limbs_add(limb_t* r, const limb_t* a, size_t an, const limb_t* b, size_t bn) {
+	limb_t carry = limbs_add_n(r, a, b, bn);
+	return limbs_add_1(r + bn, a + bn, an - bn, carry);
+}
+
+// r = a - b（an >= bn），结果 an 个limb，返回借位
+inline limb_t limbs_sub(limb_t* r, const limb_t* a, size_t an, const limb_t* b, size_t bn) {
+	limb_t borrow = limbs_sub_n(r, a, b, bn);
+	return limbs_sub_1(r + bn, a + bn, an - bn, borrow);
+}
+
+// 以下两个内层循环把乘积拆成高低两个limb分别进位，而不是整段做128位加法：
+// 编译器能生成更短的依赖链，乘法和 Montgomery 约简的热点循环因此快约三成
+
+// r = a * b（b 是单个limb），返回最高位进位
+inline limb_t limbs_mul_1(limb_t* r, const limb_t* a, size_t n, limb_t b) {
+	limb_t carry = 0;
+	for (size_t i = 0; i < n; i++) {
+		dlimb_t p = (dlimb_t)a[i] * b;
+		limb_t lo = (limb_t)p + carry;
+		carry = (limb_t)(p >> 64) + (lo < carry);
+		r[i] = lo;
+	}
+	return carry;
+}
+
+// r += a * b（b 是单个limb），返回最高位进位
+inline limb_t limbs_addmul_1(limb_t* r, const limb_t* a, size_t n, limb_t b) {
+	limb_t carry = 0;
+	for (size_t i = 0; i < n; i++) {
+		dlimb_t p = (dlimb_t)a[i] * b;
+		limb_t lo = (limb_t)p + carry, hi = (limb_t)(p >> 64) + (lo < carry);
+		limb_t x = r[i] + lo;
+		r[i] = x;
+		carry = hi + (x < lo);
+	}
+	return carry;
+}
+
+// r -= a * b（b 是单个limb），返回最高位借位
+inline limb_t limbs_submul_1(limb_t* r, const limb_t* a, size_t n, limb_t b) {
+	limb_t borrow = 0;
+	for (size_t i = 0; i < n; i++) {
+		dlimb_t t = (dlimb_t)a[i] * b + borrow;
+		limb_t lo = (limb_t)t;
+		borrow = (limb_t)(t >> 64);
+		limb_t x = r[i];
+		r[i] = x - lo;
+		borrow += x < lo;
+	}
+	return borrow;
+}
+
+// 比较两个 n 个limb的数
+inline int limbs_cmp(const limb_t* a, const limb_t* b, size_t n) {
+	while (n-- > 0) {
+		if (a[n] != b[n]) return a[n] < b[n] ? -1 : 1;
+	}
+	return 0;
+}
+
+// 左移 s 位（0 <= s < 64），返回移出的高位
+inline limb_t limbs_lshift(limb_t* r, const limb_t* a, size_t n, int s) {
+	if (s == 0) {
+		std::copy(a, a + n, r);
+		return 0;
+	}
+	limb_t out = a[n - 1] >> (64 - s);
+	for (size_t i = n - 1; i > 0; i--) r[i] = (a[i] << s) | (a[i - 1] >> (64 - s));
+	r[0] = a[0] << s;
+	return out;
+}
+
+// 右移 s 位（0 <= s < 64）
+inline void limbs_rshift(limb_t* r, const limb_t* a, size_t n, int s) {
+	if (s == 0) {
+		std::copy(a, a + n, r);
+		return;
+	}
+	for (size_t i = 0; i + 1 < n; i++) r[i] = (a[i] >> s) | (a[i + 1] << (64 - s));
+	r[n - 1] = a[n - 1] >> s;
+}
+
+// 朴素乘法：r[0, an+bn) = a * b
+inline void limbs_mul_basecase(limb_t* r, const limb_t* a, size_t an, const limb_t* b, size_t bn) {
+	r[an] = limbs_mul_1(r, a, an, b[0]);
+	for (size_t j = 1; j < bn; j++) {
+		r[an + j] = limbs_addmul_1(r + j, a, an, b[j]);
+	}
+}
+
+// 朴素平方：先算交叉项再翻倍，最后加上对角线
+inline void limbs_sqr_basecase(limb_t* r, const limb_t* a, size_t n) {
+	std::fill(r, r + 2 * n, 0);
+	for (size_t i = 0; i + 1 < n; i++) {
+		r[i + n] = limbs_addmul_1(r + 2 * i + 1, a + i + 1, n - i - 1, a[i]);
+	}
+	limbs_lshift(r, r, 2 * n, 1);
+	limb_t carry = 0;
+	for (size_t i = 0; i < n; i++) {
+		dlimb_t sq = (dlimb_t)a[i] * a[i];
+		dlimb_t s = (dlimb_t)r[2 * i] + (limb_t)sq + carry;
+		r[2 * i] = (limb_t)s;
+		s = (dlimb_t)r[2 * i + 1] + (limb_t)(sq >> 64) + (limb_t)(s >> 64);
+		r[2 * i + 1] = (limb_t)s;
+		carry = (limb_t)(s >> 64);
+	}
+}
+
+// Karatsuba 乘法：r[0, 2n) = a * b（各 n 个limb）
+inline void limbs_mul_n(limb_t* r, const limb_t* a, const limb_t* b, size_t n) {
+	if (n < KARATSUBA_THRESHOLD) {
+		limbs_mul_basecase(r, a, n, b, n);
+		return;
+	}
+	size_t h = n / 2, hh = n - h;
+	limbs_mul_n(r, a, b, h);                   // z0 = a0*b0
+	limbs_mul_n(r + 2 * h, a + h, b + h, hh);  // z2 = a1*b1
+	std::vector<limb_t> sa(hh + 1), sb(hh + 1), t(2 * hh + 2);
+	sa[hh] = limbs_add(sa.data(), a + h, hh, a, h);
+	sb[hh] = limbs_add(sb.data(), b + h, hh, b, h);
+	limbs_mul_n(t.data(), sa.data(), sb.data(), hh + 1);
+	// z1 = (a0+a1)(b0+b1) - z0 - z2
+	limbs_sub(t.data(), t.data(), 2 * hh + 2, r, 2 * h);
+	limbs_sub(t.data(), t.data(), 2 * hh + 2, r + 2 * h, 2 * hh);
+	limbs_add(r + h, r + h, n + hh, t.data(), 2 * hh + 2);
+}
+
+// Karatsuba 平方：r[0, 2n) = a^2
+inline void limbs_sqr_n(limb_t* r, const limb_t* a, size_t n) {
+	if (n < KARATSUBA_THRESHOLD) {
+		limbs_sqr_basecase(r, a, n);
+		return;
+	}
+	size_t h = n / 2, hh = n - h;
+	limbs_sqr_n(r, a, h);
+	limbs_sqr_n(r + 2 * h, a + h, hh);
+	std::vector<limb_t> sa(hh + 1), t(2 * hh + 2);
+	sa[hh] = limbs_add(sa.data(), a + h, hh, a, h);
+	limbs_sqr_n(t.data(), sa.data(), hh + 1);
+	limbs_sub(t.data(), t.data(), 2 * hh + 2, r, 2 * h);
+	limbs_sub(t.data(), t.data(), 2 * hh + 2, r + 2 * h, 2 * hh);
+	limbs_add(r + h, r + h, n + hh, t.data(), 2 * hh + 2);
+}
+
+// 一般乘法：r[0, an+bn) = a * b，要求 an >= bn >= 1，r 不能与 a、b 重叠
+inline void limbs_mul(limb_t* r, const limb_t* a, size_t an, const limb_t* b, size_t bn) {
+	if (bn < KARATSUBA_THRESHOLD) {
+		limbs_mul_basecase(r, a, an, b, bn);
+		return;
+	}
+	if (an == bn) {
+		limbs_mul_n(r, a, b, bn);
+		return;
+	}
+	// 不平衡：把 a 切成 bn 大小的块，逐块做平衡乘法再累加
+	std::fill(r, r + an + bn, 0);
+	std::vector<limb_t> tmp(2 * bn);
+	for (size_t off = 0; off < an; off += bn) {
+		size_t len = std::min(bn, an - off);
+		if (len == bn) {
+			limbs_mul_n(tmp.data(), a + off, b, bn);
+		} else if (len >= KARATSUBA_THRESHOLD) {
+			limbs_mul(tmp.data(), b, bn, a + off, len);
+		} else {
+			limbs_mul_basecase(tmp.data(), b, bn, a + off, len);
+		}
+		limbs_add(r + off, r + off, an + bn - off, tmp.data(), len + bn);
+	}
+}
+
+// 单limb除数的预求逆（Möller–Granlund）：d 最高位为1，返回 floor((β^2-1)/d) - β
+inline limb_t limb_reciprocal(limb_t d) {
+	return (limb_t)(~(dlimb_t)0 / d);
+}
+
+// <u1, u0> mod d（要求 u1 < d，d 最高位为1，v = limb_reciprocal(d)）：两次乘法代替一次128位除法
+inline limb_t limb_mod_preinv(limb_t u1, limb_t u0, limb_t d, limb_t v) {
+	dlimb_t q = (dlimb_t)v * u1 + (((dlimb_t)(u1 + 1) << 64) | u0);
+	limb_t r = u0 - (limb_t)(q >> 64) * d;
+	// 第一次修正约一半概率发生，用掩码代替分支；第二次极少发生
+	r += d & (0 - (limb_t)(r > (limb_t)q));
+	if (r >= d) r -= d;
+	return r;
+}
+
+// r[j] = a（n 个limb）mod d[j]，j < 4，d[j] 最高位为1、v[j] 为其预求逆。
+// 四条约简链互不依赖，交错执行能填满乘法流水线，比逐个模数各扫一遍快得多。
+// 模数 m 不是规格化的也没关系：取 d = m·2^s，a mod d 再对 m 取模即可
+inline void limbs_mod_1_preinv_4(const limb_t* a, size_t n, const limb_t* d, const limb_t* v, limb_t* r) {
+	limb_t r0 = 0, r1 = 0, r2 = 0, r3 = 0;
+	for (size_t i = n; i-- > 0;) {
+		limb_t u = a[i];
+		r0 = limb_mod_preinv(r0, u, d[0], v[0]);
+		r1 = limb_mod_preinv(r1, u, d[1], v[1]);
+		r2 = limb_mod_preinv(r2, u, d[2], v[2]);
+		r3 = limb_mod_preinv(r3, u, d[3], v[3]);
+	}
+	r[0] = r0;
+	r[1] = r1;
+	r[2] = r2;
+	r[3] = r3;
+}
+
+// ==================== 无符号大整数 ====================
+
+class BigUInt {
+private:
+	std::vector<limb_t> limbs;  // 小端，无高位零；0 表示为空数组
+
+	void trim() {
+		while (!limbs.empty() && limbs.back() == 0) limbs.pop_back();
+	}
+
+	static int digit_value(char c) {
+		if (c >= '0' && c <= '9') return c - '0';
+		if (c >= 'a' && c <= 'z') return c - 'a' + 10;
+		if (c >= 'A' && c <= 'Z') return c - 'A' + 10;
+		return 99;
+	}
+
+	// base^k 是不超过 2^64-1 的最大幂，k 为每个limb可容纳的位数
+	static void chunk_info(int base, int& k, limb_t& big) {
+		k = 0;
+		big = 1;
+		while (big <= UINT64_MAX / (limb_t)base) {
+			big *= base;
+			k++;
+		}
+	}
+
+	static bool is_pow2_base(int base, int& bits) {
+		bits = 0;
+		while ((1 << bits) < base) bits++;
+		return (1 << bits) == base;
+	}
+
+	// 十进制（或其他进制）输入：分治合并，[lo, hi) 为低位在前的块下标
+	static BigUInt combine_chunks(const std::vector<limb_t>& chunks, size_t lo, size_t hi, limb_t big,
+		std::vector<BigUInt>& pows) {
+		if (hi - lo <= CONVERT_THRESHOLD) {
+			BigUInt x;
+			for (size_t i = hi; i-- > lo;) x.mul_add_small(big, chunks[i]);
+			return x;
+		}
+		size_t level = 0;
+		while (((size_t)2 << level) < hi - lo) level++;
+		size_t mid = lo + ((size_t)1 << level);
+		while (pows.size() <= level) pows.push_back(pows.empty() ? BigUInt(big) : pows.back().sqr());
+		BigUInt high = combine_chunks(chunks, mid, hi, big, pows);
+		return high * pows[level] + combine_chunks(chunks, lo, mid, big, pows);
+	}
+
+	// 输出：分治，pad 为需要补足的位数（0 表示最高部分，不补前导零）
+	static void to_string_rec(const BigUInt& x, int level, size_t pad, int base, int k, limb_t big,
+		const std::vector<BigUInt>& pows, std::string& out) {
+		if (level < 0 || x.limbs.size() < CONVERT_THRESHOLD) {
+			static const char digits[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+			std::string s;
+			BigUInt t = x;
+			while (!t.is_zero()) {
+				limb_t chunk = t.divmod_small(big);
+				for (int i = 0; i < k; i++) {
+					s.push_back(digits[chunk % base]);
+					chunk /= base;
+				}
+			}
+			while (!s.empty() && s.back() == '0') s.pop_back();
+			if (s.size() < pad) s.append(pad - s.size(), '0');
+			out.append(s.rbegin(), s.rend());
+			return;
+		}
+		BigUInt q, r;
+		divmod(x, pows[level], q, r);
+		size_t low_digits = (size_t)k << level;
+		if (pad == 0 && q.is_zero()) {
+			to_string_rec(r, level - 1, 0, base, k, big, pows, out);
+			return;
+		}
+		to_string_rec(q, level - 1, pad > low_digits ? pad - low_digits : 0, base, k, big, pows, out);
+		to_string_rec(r, level - 1, low_digits, base, k, big, pows, out);
+	}
+
+	// 朴素除法（Knuth 算法 D）：b 至少一个limb
+	static void divmod_schoolbook(const BigUInt& a, const BigUInt& b, BigUInt& q, BigUInt& r) {
+		size_t n = b.limbs.size();
+		if (n == 1) {
+			BigUInt t = a;
+			limb_t rem = t.divmod_small(b.limbs[0]);
+			q = std::move(t);
+			r = BigUInt(rem);
+			return;
+		}
+		size_t m = a.limbs.size() - n;
+		int s = limb_clz(b.limbs[n - 1]);
+		std::vector<limb_t> vn(n), un(a.limbs.size() + 1);
+		limbs_lshift(vn.data(), b.limbs.data(), n, s);
+		un[a.limbs.size()] = limbs_lshift(un.data(), a.limbs.data(), a.limbs.size(), s);
+		std::vector<limb_t> qv(m + 1);
+		limb_t vtop = vn[n - 1], vsec = vn[n - 2];
+		for (size_t j = m + 1; j-- > 0;) {
+			dlimb_t num = ((dlimb_t)un[j + n] << 64) | un[j + n - 1];
+			dlimb_t qhat = num / vtop;
+			dlimb_t rhat = num - qhat * vtop;
+			while ((qhat >> 64) != 0 || qhat * vsec > ((rhat << 64) | un[j + n - 2])) {
+				qhat--;
+				rhat += vtop;
+				if ((rhat >> 64) != 0) break;
+			}
+			limb_t borrow = limbs_submul_1(un.data() + j, vn.data(), n, (limb_t)qhat);
+			limb_t top = un[j + n];
+			un[j + n] = top - borrow;
+			if (top < borrow) {
+				qhat--;
+				un[j + n] += limbs_add_n(un.data() + j, un.data() + j, vn.data(), n);
+			}
+			qv[j] = (limb_t)qhat;
+		}
+		q.limbs = std::move(qv);
+		q.trim();
+		r.limbs.assign(n, 0);
+		limbs_rshift(r.limbs.data(), un.data(), n, s);
+		r.trim();
+	}
+
+	// Burnikel-Ziegler：[A12 A3] / B，B 有 2h 个limb且已规范化，A12 < B·β^h
+	static void bz_div3n2n(const BigUInt& a12, const BigUInt& a3, const BigUInt& b, size_t h,
+		BigUInt& q, BigUInt& r) {
+		BigUInt b1 = b.shift_limbs_right(h);
+		BigUInt b2 = b.low_limbs(h);
+		BigUInt r1;
+		if (a12.shift_limbs_right(h) < b1) {
+			bz_div2n1n(a12, b1, h, q, r1);
+		} else {
+			// 商的估计值取 β^h - 1，余数 R1 = A12 - (β^h - 1)·B1
+			q.limbs.assign(h, ~(limb_t)0);
+			r1 = a12 + b1 - b1.shift_limbs_left(h);
+		}
+		BigUInt d = q * b2;
+		BigUInt rh = r1.shift_limbs_left(h) + a3;
+		while (rh < d) {
+			rh += b;
+			q -= BigUInt(1);
+		}
+		r = rh - d;
+	}
+
+	// Burnikel-Ziegler：A / B，B 有 n 个limb且已规范化，A < B·β^n
+	static void bz_div2n1n(const BigUInt& a, const BigUInt& b, size_t n, BigUInt& q, BigUInt& r) {
+		if (n % 2 == 1 || n < BZ_THRESHOLD) {
+			if (a < b) {
+				q = BigUInt();
+				r = a;
+			} else {
+				divmod_schoolbook(a, b, q, r);
+			}
+			return;
+		}
+		size_t h = n / 2;
+		BigUInt a123 = a.shift_limbs_right(h);
+		BigUInt q1, q2, rm;
+		bz_div3n2n(a123.shift_limbs_right(h), a123.low_limbs(h), b, h, q1, rm);
+		bz_div3n2n(rm, a.low_limbs(h), b, h, q2, r);
+		q = q1.shift_limbs_left(h) + q2;
+	}
+
+	static void divmod_bz(const BigUInt& a, const BigUInt& b, BigUInt& q, BigUInt& r) {
+		size_t n = b.limbs.size();
+		// 把除数补到 j·2^k 个limb（j < BZ_THRESHOLD），保证每层递归都能对半分
+		size_t k = 0;
+		while ((n >> k) >= BZ_THRESHOLD) k++;
+		size_t np = ((n + ((size_t)1 << k) - 1) >> k) << k;
+		size_t shift = (np - n) * 64 + limb_clz(b.limbs.back());
+		BigUInt bb = b << shift;
+		BigUInt aa = a << shift;
+		size_t block_bits = np * 64;
+		size_t t = std::max<size_t>(2, (aa.bit_length() + 1 + block_bits - 1) / block_bits);
+		BigUInt z = aa.shift_limbs_right(np * (t - 2));
+		BigUInt quot, rem;
+		for (size_t i = t - 1; i-- > 0;) {
+			BigUInt qi;
+			bz_div2n1n(z, bb, np, qi, rem);
+			quot = quot.shift_limbs_left(np) + qi;
+			if (i > 0) z = rem.shift_limbs_left(np) + aa.shift_limbs_right(np * (i - 1)).low_limbs(np);
+		}
+		q = std::move(quot);
+		r = rem >> shift;
+	}
+
+public:
+	BigUInt() {}
+
+	BigUInt(uint64_t v) {
+		if (v) limbs.push_back(v);
+	}
+
+	// 从字符串构造（进制 2-36），非法字符抛出 invalid_argument
+	explicit BigUInt(const std::string& s, int base = 10) {
+		*this = from_string(s, base);
+	}
+
+	// 从小端limb数组构造
+	static BigUInt from_limbs(std::vector<limb_t> v) {
+		BigUInt x;
+		x.limbs = std::move(v);
+		x.trim();
+		return x;
+	}
+
+	const std::vector<limb_t>& limb_vector() const { return limbs; }
+	size_t size() const { return limbs.size(); }
+	limb_t limb(size_t i) const { return i < limbs.size() ? limbs[i] : 0; }
+
+	bool is_zero() const { return limbs.empty(); }
+	bool is_one() const { return limbs.size() == 1 && limbs[0] == 1; }
+	bool is_odd() const { return !limbs.empty() && (limbs[0] & 1); }
+	bool fits_u64() const { return limbs.size() <= 1; }
+	uint64_t low_u64() const { return limbs.empty() ? 0 : limbs[0]; }
+
+	size_t bit_length() const {
+		if (limbs.empty()) return 0;
+		return limbs.size() * 64 - limb_clz(limbs.back());
+	}
+
+	bool test_bit(size_t i) const {
+		size_t w = i / 64;
+		return w < limbs.size() && ((limbs[w] >> (i % 64)) & 1);
+	}
+
+	// 末尾连续零比特的个数（0 返回 0）
+	size_t trailing_zeros() const {
+		for (size_t i = 0; i < limbs.size(); i++) {
+			if (limbs[i]) return i * 64 + limb_ctz(limbs[i]);
+		}
+		return 0;
+	}
+
+	// 低 n 个limb
+	BigUInt low_limbs(size_t n) const {
+		if (n >= limbs.size()) return *this;
+		return from_limbs(std::vector<limb_t>(limbs.begin(), limbs.begin() + n));
+	}
+
+	// 低 n 位（对 2^n 取模）
+	BigUInt low_bits(size_t n) const {
+		if (n >= limbs.size() * LIMB_BITS) return *this;
+		std::vector<limb_t> v(limbs.begin(), limbs.begin() + (n + LIMB_BITS - 1) / LIMB_BITS);
+		if (n % LIMB_BITS) v.back() &= ((limb_t)1 << (n % LIMB_BITS)) - 1;
+		return from_limbs(std::move(v));
+	}
+
+	// 乘以 β^n / 除以 β^n（β = 2^64）
+	BigUInt shift_limbs_left(size_t n) const {
+		if (is_zero() || n == 0) return *this;
+		BigUInt r;
+		r.limbs.assign(n, 0);
+		r.limbs.insert(r.limbs.end(), limbs.begin(), limbs.end());
+		return r;
+	}
+
+	BigUInt shift_limbs_right(size_t n) const {
+		if (n >= limbs.size()) return BigUInt();
+		BigUInt r;
+		r.limbs.assign(limbs.begin() + n, limbs.end());
+		return r;
+	}
+
+	// ---------- 比较 ----------
+
+	static int compare(const BigUInt& a, const BigUInt& b) {
+		if (a.limbs.size() != b.limbs.size()) return a.limbs.size() < b.limbs.size() ? -1 : 1;
+		return limbs_cmp(a.limbs.data(), b.limbs.data(), a.limbs.size());
+	}
+
+	bool operator==(const BigUInt& o) const { return limbs == o.limbs; }
+	bool operator!=(const BigUInt& o) const { return limbs != o.limbs; }
+	bool operator<(const BigUInt& o) const { return compare(*this, o) < 0; }
+	bool operator<=(const BigUInt& o) const { return compare(*this, o) <= 0; }
+	bool operator>(const BigUInt& o) const { return compare(*this, o) > 0; }
+	bool operator>=(const BigUInt& o) const { return compare(*this, o) >= 0; }
+
+	// ---------- 加减 ----------
+
+	BigUInt& operator+=(const BigUInt& o) {
+		if (limbs.size() < o.limbs.size()) limbs.resize(o.limbs.size(), 0);
+		limb_t carry = limbs_add(limbs.data(), limbs.data(), limbs.size(), o.limbs.data(), o.limbs.size());
+		if (carry) limbs.push_back(carry);
+		return *this;
+	}
+
+	// 要求 *this >= o，否则抛出 domain_error
+	BigUInt& operator-=(const BigUInt& o) {
+		if (*this < o) throw std::domain_error("减法结果为负");
+		limbs_sub(limbs.data(), limbs.data(), limbs.size(), o.limbs.data(), o.limbs.size());
+		trim();
+		return *this;
+	}
+
+	friend BigUInt operator+(BigUInt a, const BigUInt& b) { return a += b; }
+	friend BigUInt operator-(BigUInt a, const BigUInt& b) { return a -= b; }
+
+	// ---------- 乘法 ----------
+
+	friend BigUInt operator*(const BigUInt& a, const BigUInt& b) {
+		PROF_SCOPE("mul", std::max(a.limbs.size(), b.limbs.size()));
+		if (a.is_zero() || b.is_zero()) return BigUInt();
+		if (&a == &b || a.limbs == b.limbs) return a.sqr();
+		const BigUInt& x = a.limbs.size() >= b.limbs.size() ? a : b;
+		const BigUInt& y = a.limbs.size() >= b.limbs.size() ? b : a;
+		BigUInt r;
+		r.limbs.resize(x.limbs.size() + y.limbs.size());
+		limbs_mul(r.limbs.data(), x.limbs.data(), x.limbs.size(), y.limbs.data(), y.limbs.size());
+		r.trim();
+		return r;
+	}
+
+	BigUInt& operator*=(const BigUInt& o) { return *this = *this * o; }
+
+	BigUInt sqr() const {
+		if (is_zero()) return BigUInt();
+		BigUInt r;
+		r.limbs.resize(2 * limbs.size());
+		limbs_sqr_n(r.limbs.data(), limbs.data(), limbs.size());
+		r.trim();
+		return r;
+	}
+
+	// 原地计算 *this = *this * m + a
+	BigUInt& mul_add_small(limb_t m, limb_t a) {
+		limb_t carry = limbs_mul_1(limbs.data(), limbs.data(), limbs.size(), m);
+		if (carry) limbs.push_back(carry);
+		if (limbs.empty()) limbs.push_back(0);
+		carry = limbs_add_1(limbs.data(), limbs.data(), limbs.size(), a);
+		if (carry) limbs.push_back(carry);
+		trim();
+		return *this;
+	}
+
+	// ---------- 除法 ----------
+
+	// 原地除以单个limb，返回余数
+	limb_t divmod_small(limb_t m) {
+		if (m == 0) throw std::domain_error("除数为0");
+		dlimb_t rem = 0;
+		for (size_t i = limbs.size(); i-- > 0;) {
+			dlimb_t cur = (rem << 64) | limbs[i];
+			limbs[i] = (limb_t)(cur / m);
+			rem = cur % m;
+		}
+		trim();
+		return (limb_t)rem;
+	}
+
+	// 对单个limb取模（不修改自身）
+	limb_t mod_small(limb_t m) const {
+		if (m == 0) throw std::domain_error("除数为0");
+		if (m <= UINT32_MAX) {
+			// 小模数：按32位半limb处理，只用64位除法
+			uint64_t rem = 0;
+			for (size_t i = limbs.size(); i-- > 0;) {
+				rem = ((rem << 32) | (limbs[i] >> 32)) % m;
+				rem = ((rem << 32) | (limbs[i] & 0xFFFFFFFFu)) % m;
+			}
+			return rem;
+		}
+		dlimb_t rem = 0;
+		for (size_t i = limbs.size(); i-- > 0;) rem = ((rem << 64) | limbs[i]) % m;
+		return (limb_t)rem;
+	}
+
+	// 除尽小因子 p（p >= 2），返回除去的次数。先按不超过一个limb的最大幂 p^e 整块除，余下的再逐个除
+	size_t remove_factor(limb_t p) {
+		if (p < 2) throw std::domain_error("因子必须不小于2");
+		limb_t pe = p;
+		size_t e = 1, count = 0;
+		while (pe <= UINT64_MAX / p) {
+			pe *= p;
+			e++;
+		}
+		while (!is_zero() && mod_small(pe) == 0) {
+			divmod_small(pe);
+			count += e;
+		}
+		while (!is_zero() && mod_small(p) == 0) {
+			divmod_small(p);
+			count++;
+		}
+		return count;
+	}
+
+	// 带余除法 a = q·b + r，b 为0时抛出 domain_error
+	static void divmod(const BigUInt& a, const BigUInt& b, BigUInt& q, BigUInt& r) {
+		PROF_SCOPE("divmod", a.limbs.size());
+		if (b.is_zero()) throw std::domain_error("除数为0");
+		if (a < b) {
+			r = a;
+			q = BigUInt();
+			return;
+		}
+		size_t n = b.limbs.size(), m = a.limbs.size() - n;
+		if (n >= BZ_THRESHOLD && m >= BZ_THRESHOLD) {
+			divmod_bz(a, b, q, r);
+		} else {
+			divmod_schoolbook(a, b, q, r);
+		}
+	}
+
+	friend BigUInt operator/(const BigUInt& a, const BigUInt& b) {
+		BigUInt q, r;
+		divmod(a, b, q, r);
+		return q;
+	}
+
+	friend BigUInt operator%(const BigUInt& a, const BigUInt& b) {
+		BigUInt q, r;
+		divmod(a, b, q, r);
+		return r;
+	}
+
+	// ---------- 移位 ----------
+
+	friend BigUInt operator<<(const BigUInt& a, size_t s) {
+		if (a.is_zero()) return a;
+		BigUInt r;
+		size_t w = s / 64;
+		r.limbs.assign(a.limbs.size() + w + 1, 0);
+		r.limbs.back() = limbs_lshift(r.limbs.data() + w, a.limbs.data(), a.limbs.size(), s % 64);
+		r.trim();
+		return r;
+	}
+
+	friend BigUInt operator>>(const BigUInt& a, size_t s) {
+		size_t w = s / 64;
+		if (w >= a.limbs.size()) return BigUInt();
+		BigUInt r;
+		r.limbs.resize(a.limbs.size() - w);
+		limbs_rshift(r.limbs.data(), a.limbs.data() + w, r.limbs.size(), s % 64);
+		r.trim();
+		return r;
+	}
+
+	BigUInt& operator<<=(size_t s) { return *this = *this << s; }
+	BigUInt& operator>>=(size_t s) { return *this = *this >> s; }
+
+	// ---------- 数论 ----------
+
+	static BigUInt pow(BigUInt base, uint64_t e) {
+		BigUInt result(1);
+		while (e) {
+			if (e & 1) result *= base;
+			e >>= 1;
+			if (e) base = base.sqr();
+		}
+		return result;
+	}
+
+	// Lehmer 最大公约数：用前导62位模拟欧几里得过程，攒够单精度商序列后一次性更新多精度数
+	static BigUInt gcd(BigUInt a, BigUInt b) {
+		PROF_SCOPE("gcd", std::max(a.limbs.size(), b.limbs.size()));
+		if (a < b) std::swap(a, b);
+		while (b.limbs.size() > 1) {
+			size_t n = a.bit_length();
+			size_t shift = n > 62 ? n - 62 : 0;
+			int64_t ah = (int64_t)(a >> shift).low_u64();
+			int64_t bh = (int64_t)(b >> shift).low_u64();
+			int64_t A = 1, B = 0, C = 0, D = 1;
+			while (bh + C != 0 && bh + D != 0) {
+				int64_t q1 = (ah + A) / (bh + C);
+				int64_t q2 = (ah + B) / (bh + D);
+				if (q1 != q2) break;
+				int64_t t = A - q1 * C; A = C; C = t;
+				t = B - q1 * D; B = D; D = t;
+				t = ah - q1 * bh; ah = bh; bh = t;
+			}
+			if (B == 0) {
+				BigUInt q, r;
+				divmod(a, b, q, r);
+				a = std::move(b);
+				b = std::move(r);
+			} else {
+				BigUInt na = lin_comb(a, A, b, B);
+				BigUInt nb = lin_comb(a, C, b, D);
+				a = std::move(na);
+				b = std::move(nb);
+			}
+		}
+		if (b.is_zero()) return a;
+		uint64_t x = b.low_u64(), y = a.mod_small(x);
+		while (y) {
+			uint64_t t = x % y;
+			x = y;
+			y = t;
+		}
+		return BigUInt(x);
+	}
+
+	// x·cx + y·cy，系数一正一负（或有零），结果保证非负
+	static BigUInt lin_comb(const BigUInt& x, int64_t cx, const BigUInt& y, int64_t cy) {
+		BigUInt px = x * BigUInt((uint64_t)(cx < 0 ? -cx : cx));
+		BigUInt py = y * BigUInt((uint64_t)(cy < 0 ? -cy : cy));
+		if (cx >= 0 && cy >= 0) return px + py;
+		return cx >= 0 ? px - py : py - px;
+	}
+
+	// 整数平方根 floor(sqrt(x))（牛顿迭代）
+	BigUInt isqrt() const {
+		if (is_zero()) return BigUInt();
+		BigUInt x = BigUInt(1) << ((bit_length() + 1) / 2);
+		while (true) {
+			BigUInt y = (x + *this / x) >> 1;
+			if (y >= x) return x;
+			x = std::move(y);
+		}
+	}
+
+	// ---------- 进制转换 ----------
+
+	static BigUInt from_string(const std::string& s, int base = 10) {
+		if (base < 2 || base > 36) throw std::invalid_argument("进制必须在2到36之间");
+		if (s.empty()) throw std::invalid_argument("空字符串");
+		for (char c : s) {
+			if (digit_value(c) >= base) throw std::invalid_argument("非法字符");
+		}
+		int bits;
+		if (is_pow2_base(base, bits)) {
+			// 2的幂进制：直接按比特拼接
+			BigUInt x;
+			x.limbs.assign((s.size() * bits + 63) / 64, 0);
+			size_t pos = 0;
+			for (size_t i = s.size(); i-- > 0; pos += bits) {
+				limb_t v = digit_value(s[i]);
+				x.limbs[pos / 64] |= v << (pos % 64);
+				if (pos % 64 + bits > 64) x.limbs[pos / 64 + 1] |= v >> (64 - pos % 64);
+			}
+			x.trim();
+			return x;
+		}
+		int k;
+		limb_t big;
+		chunk_info(base, k, big);
+		// 从低位起每 k 位一块
+		std::vector<limb_t> chunks;
+		for (size_t end = s.size(); end > 0;) {
+			size_t start = end >= (size_t)k ? end - k : 0;
+			limb_t v = 0;
+			for (size_t i = start; i < end; i++) v = v * base + digit_value(s[i]);
+			chunks.push_back(v);
+			end = start;
+		}
+		std::vector<BigUInt> pows;
+		// 最高块可能不足 k 位，但按 k 位处理不影响结果（高位补零）
+		return combine_chunks(chunks, 0, chunks.size(), big, pows);
+	}
+
+	std::string to_string(int base = 10) const {
+		if (base < 2 || base > 36) throw std::invalid_argument("进制必须在2到36之间");
+		if (is_zero()) return "0";
+		static const char digits[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+		int bits;
+		if (is_pow2_base(base, bits)) {
+			std::string s;
+			size_t total = bit_length();
+			for (size_t pos = 0; pos < total; pos += bits) {
+				limb_t v = limbs[pos / 64] >> (pos % 64);
+				if (pos % 64 + bits > 64 && pos / 64 + 1 < limbs.size()) v |= limbs[pos / 64 + 1] << (64 - pos % 64);
+				s.push_back(digits[v & ((1u << bits) - 1)]);
+			}
+			while (s.size() > 1 && s.back() == '0') s.pop_back();
+			return std::string(s.rbegin(), s.rend());
+		}
+		int k;
+		limb_t big;
+		chunk_info(base, k, big);
+		std::vector<BigUInt> pows{BigUInt(big)};
+		while (pows.back().limbs.size() <= limbs.size()) pows.push_back(pows.back().sqr());
+		std::string out;
+		to_string_rec(*this, (int)pows.size() - 2, 0, base, k, big, pows, out);
+		return out;
+	}
+};
+
+// ==================== 多模数余数 ====================
+// 同时求一个大整数对一批小模数（各自小于 2^32）的余数：模数按顺序打包成乘积不超过一个limb的若干组，
+// 组乘积左移到最高位为1并预求逆，每四组共用一遍limb扫描（每个limb每组两次乘法，不做除法），
+// 得到 n 对各组的余数后再逐个模数取余。前几千个素数每组能装3到7个，
+// 筛选成本从每个素数一整遍除法降到每十几个素数一遍乘法。
+
+class SmallModuli {
+private:
+	std::vector<uint32_t> moduli_;
+	std::vector<limb_t> d_, v_;      // 各组规格化后的乘积及其预求逆，补齐到4的倍数
+	std::vector<size_t> first_;      // 第 g 组的模数下标为 [first_[g], first_[g+1])
+
+	// 处理从第 g 组起的四组，对其中前 count 个模数逐个调用 f(下标, 余数)，f 返回 false 时停止
+	template <class F>
+	bool scan(const BigUInt& n, size_t count, F f) const {
+		const std::vector<limb_t>& a = n.limb_vector();
+		limb_t r[4];
+		for (size_t g = 0; g + 1 < first_.size() && first_[g] < count; g += 4) {
+			limbs_mod_1_preinv_4(a.data(), a.size(), &d_[g], &v_[g], r);
+			for (size_t j = 0; j < 4 && g + j + 1 < first_.size(); j++) {
+				for (size_t i = first_[g + j]; i < first_[g + j + 1] && i < count; i++) {
+					if (!f(i, (uint32_t)(r[j] % moduli_[i]))) return false;
+				}
+			}
+		}
+		return true;
+	}
+
+public:
+	SmallModuli() {}
+
+	explicit SmallModuli(std::vector<uint32_t> moduli) : moduli_(std::move(moduli)) {
+		if (std::find(moduli_.begin(), moduli_.end(), 0u) != moduli_.end()) throw std::domain_error("除数为0");
+		for (size_t i = 0; i < moduli_.size();) {
+			first_.push_back(i);
+			limb_t product = 1;
+			while (i < moduli_.size() && product <= UINT64_MAX / moduli_[i]) product *= moduli_[i++];
+			d_.push_back(product << limb_clz(product));
+			v_.push_back(limb_reciprocal(d_.back()));
+		}
+		first_.push_back(moduli_.size());
+		while (d_.size() % 4) {
+			d_.push_back(~(limb_t)0);
+			v_.push_back(limb_reciprocal(d_.back()));
+		}
+	}
+
+	// 直接使用预先算好的分组（例如从预计算素数表读出），不再逐组求逆；
+	// d、v 须补齐到4的倍数，first 比实际组数多一项
+	SmallModuli(std::vector<uint32_t> moduli, std::vector<limb_t> d, std::vector<limb_t> v, std::vector<size_t> first)
+		: moduli_(std::move(moduli)), d_(std::move(d)), v_(std::move(v)), first_(std::move(first)) {
+		if (d_.size() != v_.size() || d_.size() % 4 || first_.empty() || first_.size() - 1 > d_.size() ||
+			first_.front() != 0 || first_.back() != moduli_.size() || !std::is_sorted(first_.begin(), first_.end())) {
+			throw std::invalid_argument("多模数余数器的预计算分组不一致");
+		}
+	}
+
+	size_t size() const { return moduli_.size(); }
+	uint32_t operator[](size_t i) const { return moduli_[i]; }
+	const std::vector<uint32_t>& moduli() const { return moduli_; }
+	const std::vector<limb_t>& group_divisors() const { return d_; }
+	const std::vector<limb_t>& group_reciprocals() const { return v_; }
+	const std::vector<size_t>& group_starts() const { return first_; }
+
+	// out[i] = n mod 第 i 个模数，只算前 count 个
+	void residues(const BigUInt& n, uint32_t* out, size_t count) const {
+		PROF_SCOPE("small_moduli", n.size());
+		scan(n, count, [&](size_t i, uint32_t r) {
+			out[i] = r;
+			return true;
+		});
+	}
+
+	std::vector<uint32_t> residues(const BigUInt& n) const {
+		std::vector<uint32_t> out(moduli_.size());
+		residues(n, out.data(), out.size());
+		return out;
+	}
+
+	// 前 count 个模数中是否有能整除 n 的
+	bool divides_any(const BigUInt& n, size_t count) const {
+		return !scan(n, count, [](size_t, uint32_t r) { return r != 0; });
+	}
+};
+
+// ==================== Montgomery 模乘 ====================
+// 奇数模 n（k 个limb）下取 R = β^k，元素 x 以 xR mod n 的 k 个limb定长数组存放。
+// 构造时一次性预计算 n' = -n^(-1) mod β、R mod n（1 的 Montgomery 形式）和 R^2 mod n（转入用），
+// 之后每次模乘只做一遍按列合并乘法与约简的乘积扫描（特大模数时为一次 Karatsuba 乘法加一次 REDC），不再做任何除法。
+// 上下文内部有一块乘积暂存区，同一个上下文不能被多个线程同时使用，每个线程各建一个即可。
+
+typedef std::vector<limb_t> MontNum;
+
+// 乘积扫描用的三limb累加器：一列中的 128 位乘积先全部加进来，再整体右移一个limb进入下一列。
+// 相邻乘积之间没有逐limb的进位链，比按行 addmul 快三到四成
+struct ColumnAccumulator {
+	dlimb_t low = 0;
+	limb_t high = 0;
+
+	void add_mul(limb_t x, limb_t y) {
+		dlimb_t p = (dlimb_t)x * y;
+		low += p;
+		high += low < p;
+	}
+
+	// 加上两倍的 (c, ch)：平方的交叉项先单独累加，最后一次性翻倍
+	void add_double(dlimb_t c, limb_t ch) {
+		ch = (ch << 1) | (limb_t)(c >> 127);
+		c <<= 1;
+		low += c;
+		high += ch + (low < c);
+	}
+
+	// 取出最低limb并右移到下一列
+	limb_t shift() {
+		limb_t r = (limb_t)low;
+		low = (low >> 64) | ((dlimb_t)high << 64);
+		high = 0;
+		return r;
+	}
+};
+
+class MontContext {
+private:
+	BigUInt n_;
+	size_t k;
+	MontNum np;                     // n 的定长limb数组
+	limb_t ninv;                    // -n^(-1) mod 2^64
+	MontNum r1, r2;                 // R mod n, R^2 mod n
+	mutable std::vector<limb_t> t;  // 2k 个limb的乘积暂存区
+
+	static MontNum fixed(const BigUInt& x, size_t k) {
+		MontNum v(k, 0);
+		for (size_t i = 0; i < x.size(); i++) v[i] = x.limb(i);
+		return v;
+	}
+
+	// 乘积扫描的收尾：暂存区高半部分是 k 个limb的结果，carry 为其上的进位，结果小于 2n，最多减一次
+	void finish_fused(MontNum& r, limb_t carry) const {
+		const limb_t* res = t.data() + k;
+		r.resize(k);
+		if (carry || limbs_cmp(res, np.data(), k) >= 0) {
+			limbs_sub_n(r.data(), res, np.data(), k);
+		} else {
+			std::copy(res, res + k, r.begin());
+		}
+	}
+
+	// 第 i 列累加 a·b 与 m·n 中下标和为 i 的全部乘积；前 k 列在列尾定出 m[i] 使该列归零，
+	// 后 k 列的低limb就是结果。m 存在暂存区低半部分，结果写进高半部分。
+	// 成员和向量都先取成局部量（kk、inv 即 k、ninv）：写 m、res 会被编译器当作可能改了它们，每次都得重新读
+	void fused_mul(MontNum& r, const MontNum& av, const MontNum& bv) const {
+		const size_t kk = k;
+		const limb_t inv = ninv;
+		limb_t *m = t.data(), *res = t.data() + kk;
+		const limb_t *n = np.data(), *a = av.data(), *b = bv.data();
+		ColumnAccumulator acc;
+		for (size_t i = 0; i < kk; i++) {
+			for (size_t j = 0; j < i; j++) {
+				acc.add_mul(a[j], b[i - j]);
+				acc.add_mul(m[j], n[i - j]);
+			}
+			acc.add_mul(a[i], b[0]);
+			m[i] = (limb_t)acc.low * inv;
+			acc.add_mul(m[i], n[0]);
+			acc.shift();
+		}
+		for (size_t i = kk; i < 2 * kk - 1; i++) {
+			for (size_t j = i - kk + 1; j < kk; j++) {
+				acc.add_mul(a[j], b[i - j]);
+				acc.add_mul(m[j], n[i - j]);
+			}
+			res[i - kk] = acc.shift();
+		}
+		res[kk - 1] = acc.shift();
+		finish_fused(r, acc.shift());
+	}
+
+	// 同上，a 的交叉项每列只算一半再翻倍
+	void fused_sqr(MontNum& r, const MontNum& av) const {
+		const size_t kk = k;
+		const limb_t inv = ninv;
+		limb_t *m = t.data(), *res = t.data() + kk;
+		const limb_t *n = np.data(), *a = av.data();
+		ColumnAccumulator acc;
+		for (size_t i = 0; i < 2 * kk - 1; i++) {
+			size_t lo = i < kk ? 0 : i - kk + 1;
+			ColumnAccumulator cross;
+			for (size_t j = lo; j < i - j; j++) cross.add_mul(a[j], a[i - j]);
+			acc.add_double(cross.low, cross.high);
+			if (i % 2 == 0) acc.add_mul(a[i / 2], a[i / 2]);
+			if (i < kk) {
+				for (size_t j = 0; j < i; j++) acc.add_mul(m[j], n[i - j]);
+				m[i] = (limb_t)acc.low * inv;
+				acc.add_mul(m[i], n[0]);
+				acc.shift();
+			} else {
+				for (size_t j = i - kk + 1; j < kk; j++) acc.add_mul(m[j], n[i - j]);
+				res[i - kk] = acc.shift();
+			}
+		}
+		res[kk - 1] = acc.shift();
+		finish_fused(r, acc.shift());
+	}
+
+	// r = t·R^(-1) mod n，t 为暂存区中的 2k 个limb（要求 t < nR）
+	void redc(MontNum& r) const {
+		limb_t* tp = t.data();
+		// 第 i 轮把 t[i] 消成0，进位本应加到 t[i+k]；后续轮次的 m 只取决于 t[i+1..k-1]，
+		// 所以进位先存进已清零的 t[i]，最后与高半部分一次性相加
+		for (size_t i = 0; i < k; i++) {
+			limb_t m = tp[i] * ninv;
+			tp[i] = limbs_addmul_1(tp + i, np.data(), k, m);
+		}
+		r.resize(k);
+		limb_t carry = limbs_add_n(r.data(), tp + k, tp, k);
+		// 结果小于 2n，最多减一次
+		if (carry || limbs_cmp(r.data(), np.data(), k) >= 0) limbs_sub_n(r.data(), r.data(), np.data(), k);
+	}
+
+public:
+	explicit MontContext(const BigUInt& n) : n_(n), k(n.size()) {
+		if (!n.is_odd() || n.is_one()) throw std::domain_error("Montgomery 模数必须是大于1的奇数");
+		np = fixed(n, k);
+		// 牛顿迭代求 n^(-1) mod 2^64：奇数的初值 n0 对低3位已正确，每轮精度翻倍，5轮到64位
+		limb_t inv = np[0];
+		for (int i = 0; i < 5; i++) inv *= 2 - np[0] * inv;
+		ninv = 0 - inv;
+		r1 = fixed((BigUInt(1) << (64 * k)) % n, k);
+		r2 = fixed((BigUInt(1) << (128 * k)) % n, k);
+		t.resize(2 * k);
+	}
+
+	const BigUInt& modulus() const { return n_; }
+	size_t limbs() const { return k; }
+
+	// 1 的 Montgomery 形式
+	const MontNum& one() const { return r1; }
+
+	// r = a·b·R^(-1) mod n，r 可以与 a、b 相同
+	void mul(MontNum& r, const MontNum& a, const MontNum& b) const {
+		PROF_SCOPE("mont_mul", k);
+		if (k < MONT_KARATSUBA_THRESHOLD) {
+			fused_mul(r, a, b);
+			return;
+		}
+		limbs_mul_n(t.data(), a.data(), b.data(), k);
+		redc(r);
+	}
+
+	// r = a^2·R^(-1) mod n，交叉项只算一半
+	void sqr(MontNum& r, const MontNum& a) const {
+		PROF_SCOPE("mont_sqr", k);
+		if (k < MONT_KARATSUBA_THRESHOLD) {
+			fused_sqr(r, a);
+			return;
+		}
+		limbs_sqr_n(t.data(), a.data(), k);
+		redc(r);
+	}
+
+	// 加减和减半与 Montgomery 形式可交换，直接在定长limb上做
+	// r = a + b mod n
+	void add(MontNum& r, const MontNum& a, const MontNum& b) const {
+		r.resize(k);
+		limb_t carry = limbs_add_n(r.data(), a.data(), b.data(), k);
+		if (carry || limbs_cmp(r.data(), np.data(), k) >= 0) limbs_sub_n(r.data(), r.data(), np.data(), k);
+	}
+
+	// r = a - b mod n
+	void sub(MontNum& r, const MontNum& a, const MontNum& b) const {
+		r.resize(k);
+		if (limbs_sub_n(r.data(), a.data(), b.data(), k)) limbs_add_n(r.data(), r.data(), np.data(), k);
+	}
+
+	// r = a/2 mod n：a 为奇数时先加上 n（n 为奇数）
+	void half(MontNum& r, const MontNum& a) const {
+		r.resize(k);
+		limb_t carry = 0;
+		if (a[0] & 1) {
+			carry = limbs_add_n(r.data(), a.data(), np.data(), k);
+		} else {
+			std::copy(a.begin(), a.end(), r.begin());
+		}
+		limbs_rshift(r.data(), r.data(), k, 1);
+		r[k - 1] |= carry << 63;
+	}
+
+	static bool is_zero(const MontNum& a) {
+		return std::all_of(a.begin(), a.end(), [](limb_t x) { return x == 0; });
+	}
+
+	// r = n - a（模 n 取负）
+	MontNum neg(const MontNum& a) const {
+		MontNum r(k, 0);
+		if (std::any_of(a.begin(), a.end(), [](limb_t x) { return x != 0; })) limbs_sub_n(r.data(), np.data(), a.data(), k);
+		return r;
+	}
+
+	MontNum to_mont(const BigUInt& a) const {
+		MontNum r = fixed(a < n_ ? a : a % n_, k);
+		mul(r, r, r2);
+		return r;
+	}
+
+	BigUInt from_mont(const MontNum& a) const {
+		std::copy(a.begin(), a.end(), t.begin());
+		std::fill(t.begin() + k, t.end(), 0);
+		MontNum r;
+		redc(r);
+		return BigUInt::from_limbs(std::move(r));
+	}
+};
+
+// ==================== 有理数 ====================
+
+// 小数展开结果：integer.non_repeating(repeating)，符号单独处理
+struct DecimalExpansion {
+	std::string integer;
+	std::string non_repeating;
+	std::string repeating;
+};
+
+// 带符号有理数，始终保持最简形式，分母为正，0 的符号为正
+class Rational {
+private:
+	int sign_;
+	BigUInt num_;
+	BigUInt den_;
+
+	void normalize() {
+		if (den_.is_zero()) throw std::domain_error("Division by zero");
+		if (num_.is_zero()) {
+			den_ = BigUInt(1);
+			sign_ = 1;
+			return;
+		}
+		BigUInt g = BigUInt::gcd(num_, den_);
+		if (!g.is_one()) {
+			num_ = num_ / g;
+			den_ = den_ / g;
+		}
+	}
+
+public:
+	Rational() : sign_(1), num_(0), den_(1) {}
+
+	Rational(int sign, const BigUInt& num, const BigUInt& den) : sign_(sign < 0 ? -1 : 1), num_(num), den_(den) {
+		normalize();
+	}
+
+	// 解析十进制小数，例如 "-123.456"、".5"、"7"
+	static Rational parse_decimal(const std::string& s) {
+		std::string str = s;
+		int sign = 1;
+		if (!str.empty() && str[0] == '-') {
+			sign = -1;
+			str = str.substr(1);
+		}
+		size_t dot = str.find('.');
+		std::string intPart = dot == std::string::npos ? str : str.substr(0, dot);
+		std::string fracPart = dot == std::string::npos ? "" : str.substr(dot + 1);
+		if (intPart.empty()) intPart = "0";
+		while (!fracPart.empty() && fracPart.back() == '0') fracPart.pop_back();
+		BigUInt num(intPart + fracPart);
+		BigUInt den = BigUInt::pow(BigUInt(10), fracPart.size());
+		return Rational(sign, num, den);
+	}
+
+	int sign() const { return sign_; }
+	const BigUInt& num() const { return num_; }
+	const BigUInt& den() const { return den_; }
+	bool is_zero() const { return num_.is_zero(); }
+
+	Rational operator-() const {
+		Rational r = *this;
+		if (!r.num_.is_zero()) r.sign_ = -r.sign_;
+		return r;
+	}
+
+	friend Rational operator+(const Rational& a, const Rational& b) {
+		BigUInt left = a.num_ * b.den_;
+		BigUInt right = b.num_ * a.den_;
+		BigUInt den = a.den_ * b.den_;
+		if (a.sign_ == b.sign_) return Rational(a.sign_, left + right, den);
+		// 异号：比较绝对值大小决定符号
+		if (left < right) return Rational(b.sign_, right - left, den);
+		return Rational(a.sign_, left - right, den);
+	}
+
+	friend Rational operator-(const Rational& a, const Rational& b) { return a + (-b); }
+
+	friend Rational operator*(const Rational& a, const Rational& b) {
+		return Rational(a.sign_ * b.sign_, a.num_ * b.num_, a.den_ * b.den_);
+	}
+
+	friend Rational operator/(const Rational& a, const Rational& b) {
+		if (b.num_.is_zero()) throw std::domain_error("Division by zero");
+		return Rational(a.sign_ * b.sign_, a.num_ * b.den_, a.den_ * b.num_);
+	}
+
+	// 分母只含2和5因子时为有限小数
+	bool is_finite_decimal() const {
+		BigUInt d = den_ >> den_.trailing_zeros();
+		d.remove_factor(5);
+		return d.is_one();
+	}
+
+	// 展开为小数：非循环部分长度等于分母中2、5因子指数的较大者，之后余数回到同一值即为一个循环节
+	DecimalExpansion expand() const {
+		DecimalExpansion e;
+		BigUInt q, rem;
+		BigUInt::divmod(num_, den_, q, rem);
+		e.integer = q.to_string();
+		if (rem.is_zero()) return e;
+
+		size_t twos = den_.trailing_zeros();
+		BigUInt d = den_ >> twos;
+		size_t fives = d.remove_factor(5);
+		size_t pre = std::max(twos, fives);
+
+		auto next_digit = [&]() {
+			rem.mul_add_small(10, 0);
+			BigUInt digit;
+			BigUInt::divmod(rem, den_, digit, rem);
+			return (char)('0' + digit.low_u64());
+		};
+		for (size_t i = 0; i < pre && !rem.is_zero(); i++) e.non_repeating.push_back(next_digit());
+		if (rem.is_zero()) return e;
+		BigUInt start = rem;
+		do {
+			e.repeating.push_back(next_digit());
+		} while (rem != start);
+		return e;
+	}
+
+	// 小数形式，循环节用括号标出，例如 -3.(142857)
+	std::string to_decimal_string() const {
+		DecimalExpansion e = expand();
+		std::string s = (sign_ < 0 ? "-" : "") + e.integer;
+		if (!e.non_repeating.empty() || !e.repeating.empty()) s += "." + e.non_repeating;
+		if (!e.repeating.empty()) s += "(" + e.repeating + ")";
+		return s;
+	}
+
+	// 分数形式，分母为1时只输出分子
+	std::string to_fraction_string() const {
+		std::string s = (sign_ < 0 ? "-" : "") + num_.to_string();
+		if (!den_.is_one()) s += "/" + den_.to_string();
+		return s;
+	}
+};
+
+}  // namespace hpcore
+
+#endif
@@ -0,0 +1,421 @@
+// 差分测试：把各工具最初的字符串 / vector<int> 实现（baseline/ 下，取自 d3cf506）与共享核心 hpcore 逐一比对，
+// 另把 prime 工具里的特殊形式约简与一般除法比对
+// 编译：g++ -std=c++17 -O2 difftest.cpp -o difftest.exe
+// 用法：difftest.exe [--seed N] [--rounds N]
+// 操作数由固定种子生成，规模按 limb 数取在各算法切换阈值（CONVERT/KARATSUBA/BZ/MONT_KARATSUBA）的两侧，
+// 每个阈值取 T-1、T、T+1 三档。旧实现都是平方级甚至更慢的算法，最大一档（约3000位十进制）单轮要几秒。
+// 有不一致时打印前几个用例并以非零状态退出。
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <random>
+#include <chrono>
+#include <regex>
+#include <stdexcept>
+#include <cmath>
+#include <numeric>
+#include <cstring>
+#include <climits>
+#include <charconv>
+#include <cctype>
+#include <cstdint>
+#include <stdlib.h>
+#include "bigint.h"
+#include "bigbin.h"
+#include "primetable.h"
+
+// 旧实现都是独立的单文件程序，各自包进命名空间；标准头文件已在上面包含，重复包含会被跳过
+namespace old_hp {
+#define main old_hp_main
+#include "baseline/High_Precision.cpp"
+#undef main
+}
+
+namespace old_prime {
+#define main old_prime_main
+#include "baseline/prime.cpp"
+#undef main
+}
+
+namespace old_frac {
+#define main old_frac_main
+#include "baseline/Fraction.cpp"
+#undef main
+}
+
+namespace old_conv {
+#define main old_conv_main
+#include "baseline/High-Precision_Base_Converter.cpp"
+#undef main
+}
+
+// 当前的 prime 工具（特殊形式约简等只在工具里的内核）
+namespace prime_tool {
+#define main prime_tool_main
+#include "prime.cpp"
+#undef main
+}
+
+using namespace std;
+using hpcore::BigUInt;
+using hpcore::MontContext;
+using hpcore::MontNum;
+using hpcore::Rational;
+
+// ==================== 参数与随机输入 ====================
+
+struct DiffOptions {
+	uint64_t seed = 20240601;
+	int rounds = 3;
+};
+
+// 与 benchmark 相同的种子派生：同一种子、同一操作、同一规模总是得到相同的输入
+uint64_t derive_seed(uint64_t seed, const string& name, long long size) {
+	uint64_t h = seed ^ 0x9E3779B97F4A7C15ULL;
+	for (char c : name) h = (h ^ (unsigned char)c) * 0x100000001B3ULL;
+	h ^= (uint64_t)size * 0xBF58476D1CE4E5B9ULL;
+	h ^= h >> 31;
+	return h;
+}
+
+// 恰好 limbs 个limb的随机数的十六进制串（最高limb非零）；top_clear 时最高位为0，top_set 时最高位为1
+string random_hex(mt19937_64& gen, size_t limbs, bool top_set = false, bool top_clear = false) {
+	static const char hex[] = "0123456789ABCDEF";
+	string s;
+	for (size_t i = 0; i < limbs; i++) {
+		uint64_t v = gen();
+		if (i == 0) {
+			if (top_set) v |= 1ULL << 63;
+			if (top_clear) v &= ~(1ULL << 63);
+			if (v >> 60 == 0) v |= 1ULL << 60;
+		}
+		for (int k = 60; k >= 0; k -= 4) s.push_back(hex[(v >> k) & 15]);
+	}
+	return s;
+}
+
+// 十六进制转十进制只走旧实现（旧 prime 的字符串乘加，逐位乘16加），不经过被测的 hpcore 转换。
+// 旧进制转换器的 multiply_by_small 把 >=10 的进位当成一位数字插入，源进制大于10时解析结果是错的，不能用在这里
+string hex_to_decimal(const string& hex) {
+	string result = "0";
+	for (char c : hex) {
+		int v = isdigit(c) ? c - '0' : c - 'A' + 10;
+		result = old_prime::add(old_prime::multiply(result, "16"), to_string(v));
+	}
+	return result;
+}
+
+// 指定进制的随机数字串（首位不为0）
+string random_base_digits(mt19937_64& gen, size_t digits, int base) {
+	static const char chars[] = "0123456789ABCDEF";
+	string s(1, chars[1 + gen() % (base - 1)]);
+	for (size_t i = 1; i < digits; i++) s.push_back(chars[gen() % base]);
+	return s;
+}
+
+string random_digits(mt19937_64& gen, size_t digits) {
+	string s;
+	s.push_back('1' + gen() % 9);
+	for (size_t i = 1; i < digits; i++) s.push_back('0' + gen() % 10);
+	return s;
+}
+
+// 大约 limbs 个limb的十进制位数
+size_t decimal_digits(size_t limbs) {
+	return max<size_t>(1, limbs * 64 * 30103 / 100000);
+}
+
+// 交互式的旧实现从 cin 读、往 cout 写：临时换掉两者的缓冲区，返回输出的最后一行
+// （去掉同一行上不带换行的输入提示，提示都以全角冒号结尾）
+string run_interactive(void (*f)(), const string& input) {
+	istringstream in(input);
+	ostringstream out;
+	streambuf* saved_in = cin.rdbuf(in.rdbuf());
+	streambuf* saved_out = cout.rdbuf(out.rdbuf());
+	f();
+	cin.rdbuf(saved_in);
+	cout.rdbuf(saved_out);
+	string s = out.str();
+	while (!s.empty() && s.back() == '\n') s.pop_back();
+	s = s.substr(s.find_last_of('\n') + 1);
+	size_t prompt = s.rfind("：");
+	return prompt == string::npos ? s : s.substr(prompt + string("：").size());
+}
+
+// ==================== 比对记录 ====================
+
+struct DiffStats {
+	long long cases = 0;
+	long long mismatches = 0;
+};
+
+map<string, DiffStats> stats;
+const int MAX_REPORTED = 5;
+int reported = 0;
+
+// 太长的数只打印首尾
+string abbreviate(const string& s) {
+	if (s.size() <= 80) return s;
+	return s.substr(0, 36) + "...(" + to_string(s.size()) + "位)..." + s.substr(s.size() - 36);
+}
+
+void check(const string& op, const string& impl, size_t limbs, const string& expected, const string& actual,
+		   const string& input) {
+	DiffStats& st = stats[op];
+	st.cases++;
+	if (expected == actual) return;
+	st.mismatches++;
+	if (reported++ >= MAX_REPORTED) return;
+	cerr << "不一致：" << op << "（" << impl << "，" << limbs << " limb）" << endl;
+	cerr << "  输入：" << abbreviate(input) << endl;
+	cerr << "  旧实现：" << abbreviate(expected) << endl;
+	cerr << "  hpcore：" << abbreviate(actual) << endl;
+}
+
+// ==================== 整数运算 ====================
+
+void diff_integers(const DiffOptions& opt, size_t limbs) {
+	mt19937_64 gen(derive_seed(opt.seed, "integer", limbs));
+	for (int round = 0; round < opt.rounds; round++) {
+		string ha = random_hex(gen, limbs), hb = random_hex(gen, limbs), hs = random_hex(gen, max<size_t>(1, limbs / 2));
+		string da = hex_to_decimal(ha), db = hex_to_decimal(hb), ds = hex_to_decimal(hs);
+		if (old_prime::compare(da, db) < 0) {
+			swap(ha, hb);
+			swap(da, db);
+		}
+		BigUInt a(da), b(db), s(ds);
+		string pair_input = da + " " + db;
+
+		// 十进制与十六进制互转：十进制串由旧实现从十六进制得到，hpcore 两个方向都转一遍
+		check("from_decimal", "old_prime", limbs, ha, a.to_string(16), da);
+		check("to_decimal", "old_prime", limbs, da, BigUInt(ha, 16).to_string(), ha);
+		// 旧进制转换器：转出（逐次除以小整数）各进制都对；转入只在源进制不超过10时可信（见 hex_to_decimal）
+		int base = 2 + gen() % 15;
+		check("to_base", "old_conv base " + to_string(base), limbs,
+			  old_conv::decimal_int_to_dest_base(old_conv::BigInt(da), base), a.to_string(base), da);
+		int src_base = 2 + gen() % 9;
+		string digits = random_base_digits(gen, ha.size() * 4 / (src_base < 4 ? 1 : src_base < 8 ? 2 : 3), src_base);
+		check("from_base", "old_conv base " + to_string(src_base), limbs,
+			  old_conv::src_base_to_decimal_int(digits, src_base).to_string(), BigUInt(digits, src_base).to_string(), digits);
+
+		check("add", "old_hp", limbs, old_hp::BigInt(da).add(old_hp::BigInt(db)).toString(), (a + b).to_string(), pair_input);
+		check("add", "old_prime", limbs, old_prime::add(da, db), (a + b).to_string(), pair_input);
+		check("sub", "old_hp", limbs, old_hp::BigInt(da).sub(old_hp::BigInt(db)).toString(), (a - b).to_string(), pair_input);
+		check("sub", "old_prime", limbs, old_prime::subtract(da, db), (a - b).to_string(), pair_input);
+		check("sub", "old_frac", limbs, old_frac::subtract(da, db), (a - b).to_string(), pair_input);
+
+		// 等长与不等长两种乘法（Karatsuba 按较短的一方判断阈值）
+		BigUInt ab = a * b, as = a * s;
+		check("mul", "old_hp", limbs, old_hp::BigInt(da).mul(old_hp::BigInt(db)).toString(), ab.to_string(), pair_input);
+		check("mul", "old_prime", limbs, old_prime::multiply(da, db), ab.to_string(), pair_input);
+		check("mul", "old_hp unbalanced", limbs, old_hp::BigInt(da).mul(old_hp::BigInt(ds)).toString(), as.to_string(),
+			  da + " " + ds);
+		check("sqr", "old_prime", limbs, old_prime::multiply(da, da), a.sqr().to_string(), da);
+
+		// 被除数约 2·limbs 个limb，除数 limbs 个limb（Burnikel-Ziegler 按除数规模切换）
+		string dn = (ab + s).to_string();
+		BigUInt q, r;
+		BigUInt::divmod(ab + s, b, q, r);
+		string div_input = dn + " / " + db;
+		auto [hq, hr] = old_hp::BigInt(dn).divmod(old_hp::BigInt(db));
+		check("divmod", "old_hp", limbs, hq.toString() + " " + hr.toString(), q.to_string() + " " + r.to_string(), div_input);
+		auto [fq, fr] = old_frac::divide(dn, db);
+		check("divmod", "old_frac", limbs, fq + " " + fr, q.to_string() + " " + r.to_string(), div_input);
+		auto [cq, cr] = old_conv::BigInt(dn).divide(old_conv::BigInt(db));
+		check("divmod", "old_conv", limbs, cq.to_string() + " " + cr.to_string(), q.to_string() + " " + r.to_string(),
+			  div_input);
+		check("mod", "old_prime", limbs, old_prime::mod_big(dn, db), r.to_string(), div_input);
+	}
+}
+
+// ==================== 最大公约数 ====================
+
+// 旧实现是逐位试商的欧几里得算法，随机大数的步数与位数成正比，只在小规模上比对随机数对；
+// 大规模用 g·x、g·y（x、y 为单limb）构造，步数少而且公约数很大
+void diff_gcd(const DiffOptions& opt, size_t limbs) {
+	if (limbs > hpcore::BZ_THRESHOLD + 1) return;
+	mt19937_64 gen(derive_seed(opt.seed, "gcd", limbs));
+	for (int round = 0; round < opt.rounds; round++) {
+		BigUInt g(hex_to_decimal(random_hex(gen, limbs)));
+		BigUInt x(gen() | 1), y(gen());
+		BigUInt a = g * x, b = g * y;
+		string input = a.to_string() + " " + b.to_string();
+		check("gcd", "old_hp", limbs, old_hp::BigInt::gcd(old_hp::BigInt(a.to_string()), old_hp::BigInt(b.to_string())).toString(),
+			  BigUInt::gcd(a, b).to_string(), input);
+		if (limbs <= 4) {
+			string da = hex_to_decimal(random_hex(gen, limbs)), db = hex_to_decimal(random_hex(gen, limbs));
+			check("gcd", "old_hp random", limbs, old_hp::BigInt::gcd(old_hp::BigInt(da), old_hp::BigInt(db)).toString(),
+				  BigUInt::gcd(BigUInt(da), BigUInt(db)).to_string(), da + " " + db);
+		}
+	}
+}
+
+// ==================== Montgomery 模乘 ====================
+
+// 模数最高位置1，乘数最高位清0，保证乘数小于模数；旧实现先乘再逐位试商取余
+void diff_montgomery(const DiffOptions& opt, size_t limbs) {
+	mt19937_64 gen(derive_seed(opt.seed, "montgomery", limbs));
+	for (int round = 0; round < opt.rounds; round++) {
+		string hn = random_hex(gen, limbs, true);
+		hn.back() = "13579BDF"[gen() % 8];
+		string dn = hex_to_decimal(hn), da = hex_to_decimal(random_hex(gen, limbs, false, true)),
+			   db = hex_to_decimal(random_hex(gen, limbs, false, true));
+		BigUInt n(dn);
+		MontContext ctx(n);
+		MontNum am = ctx.to_mont(BigUInt(da)), bm = ctx.to_mont(BigUInt(db)), r;
+		old_hp::BigInt on(dn), oa(da);
+		ctx.mul(r, am, bm);
+		check("mont_mul", "old_hp", limbs, oa.mul(old_hp::BigInt(db)).mod(on).toString(), ctx.from_mont(r).to_string(),
+			  da + " * " + db + " mod " + dn);
+		ctx.sqr(r, am);
+		check("mont_sqr", "old_hp", limbs, oa.mul(oa).mod(on).toString(), ctx.from_mont(r).to_string(), da + "^2 mod " + dn);
+	}
+}
+
+// ==================== 有理数 ====================
+
+// 循环节不超过10位的素数（1/9091 的循环节最长，为10位），乘起来的分母循环节也短，旧实现逐位展开能很快找到循环
+const uint32_t short_period_primes[] = {3, 7, 11, 13, 37, 41, 101, 239, 271, 4649, 9091};
+
+// 小数约分（旧 Fraction.cpp 的模式1、旧 High_Precision 的 Fraction 构造）、分数展开（旧 Fraction.cpp 的模式2）
+// 和四则运算；整数部分随规模变长，小数部分和分母保持较短，否则旧实现的约分和展开太慢
+void diff_rationals(const DiffOptions& opt, size_t limbs) {
+	mt19937_64 gen(derive_seed(opt.seed, "rational", limbs));
+	size_t digits = decimal_digits(limbs);
+	auto random_decimal = [&](size_t int_digits) {
+		string s = gen() % 2 ? "-" : "";
+		s += random_digits(gen, int_digits);
+		size_t frac = gen() % 30;
+		if (frac) s += "." + random_digits(gen, frac) + string(gen() % 3, '0');
+		return s;
+	};
+	for (int round = 0; round < opt.rounds; round++) {
+		// 约分
+		string s = random_decimal(digits);
+		Rational value = Rational::parse_decimal(s);
+		string reduced = (value.sign() < 0 ? "-" : "") + value.num().to_string() + "/" + value.den().to_string();
+		check("reduce", "old_frac", limbs, run_interactive(old_frac::decimalToFraction, s + "\n"), reduced, s);
+		check("reduce", "old_hp", limbs, old_hp::Fraction(s).toFractionString(), value.to_fraction_string(), s);
+
+		// 展开：分母为 2^i·5^j 乘若干循环节较短的素数，分子不约分直接交给两边
+		BigUInt den = BigUInt(1) << (gen() % 8);
+		den = den * BigUInt::pow(BigUInt(5), gen() % 6);
+		for (uint32_t p : short_period_primes) {
+			if (gen() % 3 == 0) den = den * BigUInt(p);
+		}
+		string num = random_digits(gen, digits);
+		int sign = gen() % 2 ? -1 : 1;
+		Rational fraction(sign, BigUInt(num), den);
+		string frac_input = (sign < 0 ? "-" : "") + num + "\n" + den.to_string() + "\n";
+		check("expand", "old_frac", limbs, run_interactive(old_frac::fractionToDecimal, frac_input), fraction.to_decimal_string(),
+			  frac_input);
+		// 旧 High_Precision 的 isFiniteDecimal 除的是临时副本、d 一直不变，分母含2或5（且不为1）时死循环，
+		// 所以它的 toString 不能调用：有限与否按 hpcore 判断，再分别比对小数形式和分数形式
+		old_hp::Fraction old_fraction(sign, old_hp::BigInt(num), old_hp::BigInt(den.to_string()));
+		if (fraction.is_finite_decimal()) {
+			check("expand", "old_hp", limbs, old_fraction.toDecimalString(), fraction.to_decimal_string(), frac_input);
+		} else {
+			check("reduce", "old_hp", limbs, old_fraction.toFractionString(), fraction.to_fraction_string(), frac_input);
+		}
+
+		// 四则运算（结果按分数形式比对）：除法的约分要对两个大数做欧几里得，只在小规模上比对
+		string t = random_decimal(digits / 2 + 1);
+		Rational a = value, b = Rational::parse_decimal(t);
+		old_hp::Fraction oa(s), ob(t);
+		string input = s + " " + t;
+		check("rational_add", "old_hp", limbs, oa.add(ob).toFractionString(), (a + b).to_fraction_string(), input);
+		check("rational_sub", "old_hp", limbs, oa.sub(ob).toFractionString(), (a - b).to_fraction_string(), input);
+		check("rational_mul", "old_hp", limbs, oa.mul(ob).toFractionString(), (a * b).to_fraction_string(), input);
+		if (limbs <= 4 && !b.is_zero()) {
+			check("rational_div", "old_hp", limbs, oa.div(ob).toFractionString(), (a / b).to_fraction_string(), input);
+		}
+	}
+}
+
+// ==================== 特殊形式约简 ====================
+
+// prime 工具里 N = k·2^n ± 1 的快速约简与一般除法比对（一般除法已在上面与旧实现比对过）。
+// 重点是 0、N、N±1 和 N 的倍数这些边界：c = -1 时 N 折叠后仍是 N，早先的实现会在这里死循环
+void diff_special_reduce(const DiffOptions& opt) {
+	mt19937_64 gen(derive_seed(opt.seed, "special_reduce", 0));
+	const prime_tool::SpecialForm forms[] = {
+		{1, 89, -1}, {3, 100, -1}, {3, 100, 1}, {5, 127, 1}, {12345, 200, -1}, {12345, 200, 1}, {1, 4423, -1}, {27, 3000, 1},
+	};
+	for (const prime_tool::SpecialForm& f : forms) {
+		prime_tool::SpecialModulus mod(f);
+		const BigUInt& N = mod.modulus();
+		vector<BigUInt> inputs = {BigUInt(0), BigUInt(1), N - BigUInt(1), N, N + BigUInt(1), N * BigUInt(2), N * BigUInt(5),
+								  N * BigUInt(f.k), N * (N - BigUInt(1)), N * (N - BigUInt(1)) + N - BigUInt(1), (N - BigUInt(1)).sqr()};
+		for (int round = 0; round < opt.rounds; round++) {
+			BigUInt m(hex_to_decimal(random_hex(gen, N.size())));
+			inputs.push_back(N * (m % N));
+			inputs.push_back(m.sqr() % N.sqr());
+		}
+		check("special_bit_length", f.to_string(), N.size(), to_string(N.bit_length()), to_string(f.bit_length()), f.to_string());
+		for (const BigUInt& x : inputs) {
+			check("special_reduce", f.to_string(), N.size(), (x % N).to_string(), mod.reduce(x).to_string(), f.to_string() + " " + x.to_string());
+		}
+	}
+}
+
+// ==================== 主程序 ====================
+
+// 各阈值两侧的规模（limb数），另加几个很小的规模
+vector<size_t> test_sizes() {
+	vector<size_t> sizes = {1, 2, 3};
+	for (size_t t : {hpcore::CONVERT_THRESHOLD, hpcore::KARATSUBA_THRESHOLD, hpcore::BZ_THRESHOLD, hpcore::MONT_KARATSUBA_THRESHOLD}) {
+		for (size_t s : {t - 1, t, t + 1}) sizes.push_back(s);
+	}
+	sort(sizes.begin(), sizes.end());
+	sizes.erase(unique(sizes.begin(), sizes.end()), sizes.end());
+	return sizes;
+}
+
+int main(int argc, char* argv[]) {
+	DiffOptions opt;
+	for (int i = 1; i < argc; i++) {
+		string arg = argv[i];
+		if (arg == "--seed" && i + 1 < argc) {
+			opt.seed = strtoull(argv[++i], nullptr, 10);
+		} else if (arg == "--rounds" && i + 1 < argc) {
+			opt.rounds = atoi(argv[++i]);
+		} else {
+			cerr << "用法：difftest [--seed N] [--rounds N]" << endl;
+			return 1;
+		}
+	}
+
+	auto start = chrono::steady_clock::now();
+	diff_special_reduce(opt);
+	for (size_t limbs : test_sizes()) {
+		auto t0 = chrono::steady_clock::now();
+		diff_integers(opt, limbs);
+		diff_gcd(opt, limbs);
+		diff_montgomery(opt, limbs);
+		diff_rationals(opt, limbs);
+		cerr << limbs << " limb：" << chrono::duration<double>(chrono::steady_clock::now() - t0).count() << " 秒" << endl;
+	}
+
+	long long total = 0, failed = 0;
+	for (auto& [op, st] : stats) {
+		cout << op << "：" << st.cases << " 个用例，" << st.mismatches << " 个不一致" << endl;
+		total += st.cases;
+		failed += st.mismatches;
+	}
+	cout << "共 " << total << " 个用例，" << failed << " 个不一致，种子 " << opt.seed << "，用时 "
+		 << chrono::duration<double>(chrono::steady_clock::now() - start).count() << " 秒" << endl;
+	return failed ? 1 : 0;
+}
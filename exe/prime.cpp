@@ -1,421 +1,4248 @@
-#include <iostream>
-#include <string>
-#include <vector>
-#include <algorithm>
-#include <random>
-#include <chrono>
-#include <stdlib.h>
-#include <cctype>
-
-using namespace std;
-
-// ==================== 函数声明 ====================
-string add(const string& a, const string& b);
-int compare(const string& a, const string& b);
-string subtract(const string& a, const string& b);
-string divide_by_2(const string& a);
-int mod(const string& a, int m);
-string multiply_mod(const string& a, const string& b, const string& n);
-string power_mod(string a, string b, const string& n);
-bool miller_rabin(const string& n);
-
-// ==================== 随机数生成器 ====================
-mt19937 rng(chrono::steady_clock::now().time_since_epoch().count());
-
-// 生成随机数字字符
-char random_digit() {
-	return '0' + (rng() % 10);
-}
-
-// 生成指定位数的随机数（首位不为0）
-string generate_random_number(int digits) {
-	if (digits <= 0) return "0";
-	
-	string num;
-	num.push_back('1' + (rng() % 9));  // 首位1-9
-	
-	for (int i = 1; i < digits; i++) {
-		num.push_back(random_digit());
-	}
-	
-	return num;
-}
-
-// ==================== 大整数运算（字符串表示） ====================
-
-// 大整数加法
-string add(const string& a, const string& b) {
-	string result;
-	int carry = 0;
-	int i = a.length() - 1, j = b.length() - 1;
-	
-	while (i >= 0 || j >= 0 || carry) {
-		int sum = carry;
-		if (i >= 0) sum += a[i--] - '0';
-		if (j >= 0) sum += b[j--] - '0';
-		result.push_back((sum % 10) + '0');
-		carry = sum / 10;
-	}
-	
-	reverse(result.begin(), result.end());
-	return result;
-}
-
-// 比较两个大整数（字符串形式）
-int compare(const string& a, const string& b) {
-	if (a.length() != b.length()) 
-		return a.length() < b.length() ? -1 : 1;
-	return a.compare(b);
-}
-
-// 大整数减法（a >= b）
-string subtract(const string& a, const string& b) {
-	if (compare(a, b) < 0) return "0";  // 确保a >= b
-	
-	string res;
-	int carry = 0;
-	int i = a.length() - 1, j = b.length() - 1;
-	
-	while (i >= 0 || j >= 0 || carry) {
-		int digit_a = i >= 0 ? a[i--] - '0' : 0;
-		int digit_b = j >= 0 ? b[j--] - '0' : 0;
-		int diff = digit_a - digit_b - carry;
-		if (diff < 0) {
-			diff += 10;
-			carry = 1;
-		} else {
-			carry = 0;
-		}
-		res.push_back(diff + '0');
-	}
-	
-	// 移除前导零
-	while (res.length() > 1 && res.back() == '0') res.pop_back();
-	reverse(res.begin(), res.end());
-	return res;
-}
-
-// 大整数除以2
-string divide_by_2(const string& a) {
-	string res;
-	int carry = 0;
-	
-	for (char ch : a) {
-		int digit = ch - '0';
-		int cur = carry * 10 + digit;
-		res.push_back((cur / 2) + '0');
-		carry = cur % 2;
-	}
-	
-	// 移除前导零
-	size_t start = res.find_first_not_of('0');
-	return (start == string::npos) ? "0" : res.substr(start);
-}
-
-// 大整数取模（模一个小整数）
-int mod(const string& a, int m) {
-	int res = 0;
-	for (char ch : a) {
-		res = (res * 10 + (ch - '0')) % m;
-	}
-	return res;
-}
-
-// 简单的乘法函数（不使用取模）
-string multiply(const string& a, const string& b) {
-	if (a == "0" || b == "0") return "0";
-	
-	int len_a = a.length();
-	int len_b = b.length();
-	vector<int> result(len_a + len_b, 0);
-	
-	// 逐位相乘
-	for (int i = len_a - 1; i >= 0; i--) {
-		for (int j = len_b - 1; j >= 0; j--) {
-			int product = (a[i] - '0') * (b[j] - '0');
-			int sum = product + result[i + j + 1];
-			result[i + j + 1] = sum % 10;
-			result[i + j] += sum / 10;
-		}
-	}
-	
-	// 转换为字符串
-	string res_str;
-	for (int num : result) {
-		if (!(res_str.empty() && num == 0)) {
-			res_str.push_back(num + '0');
-		}
-	}
-	
-	return res_str.empty() ? "0" : res_str;
-}
-
-// 大整数取模（模一个大整数）
-string mod_big(const string& a, const string& n) {
-	if (compare(a, n) < 0) return a;
-	
-	// 使用长除法取模
-	string remainder = "0";
-	
-	for (char digit : a) {
-		remainder.push_back(digit);
-		// 移除前导零
-		while (remainder.length() > 1 && remainder[0] == '0') {
-			remainder.erase(0, 1);
-		}
-		
-		// 如果remainder >= n，则减去除数
-		while (compare(remainder, n) >= 0) {
-			remainder = subtract(remainder, n);
-		}
-	}
-	
-	return remainder;
-}
-
-// 大整数乘法取模 (a * b) % n
-string multiply_mod(const string& a, const string& b, const string& n) {
-	if (a == "0" || b == "0") return "0";
-	
-	string result = "0";
-	
-	// 从b的最低位开始
-	for (int i = b.length() - 1; i >= 0; i--) {
-		int digit = b[i] - '0';
-		
-		if (digit != 0) {
-			// 计算 a * digit
-			string temp = a;
-			int carry = 0;
-			
-			// 乘以单个数字
-			for (int j = temp.length() - 1; j >= 0; j--) {
-				int product = (temp[j] - '0') * digit + carry;
-				temp[j] = (product % 10) + '0';
-				carry = product / 10;
-			}
-			
-			if (carry > 0) {
-				temp = to_string(carry) + temp;
-			}
-			
-			// 添加适当的零（对应位权）
-			temp += string(b.length() - 1 - i, '0');
-			
-			// 累加到结果
-			result = add(result, temp);
-			
-			// 取模
-			result = mod_big(result, n);
-		}
-	}
-	
-	return result;
-}
-
-// 快速幂取模 (a^b mod n)
-string power_mod(string a, string b, const string& n) {
-	string result = "1";
-	
-	while (compare(b, "0") > 0) {
-		// 如果b是奇数
-		if ((b.back() - '0') % 2 == 1) {
-			result = multiply_mod(result, a, n);
-		}
-		
-		// a = a * a mod n
-		a = multiply_mod(a, a, n);
-		
-		// b = b / 2
-		b = divide_by_2(b);
-	}
-	
-	return result;
-}
-
-// ==================== 米勒-拉宾素性测试 ====================
-
-// 对于 10^100 以内的数，使用以下基可以确保确定性测试
-const int bases[] = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37};
-
-bool miller_rabin(const string& n) {
-	// 处理小数字
-	if (n == "2" || n == "3") return true;
-	if (n == "1" || n == "0") return false;
-	
-	// 检查是否为偶数
-	if ((n.back() - '0') % 2 == 0) return false;
-	
-	// 将 n-1 写成 d * 2^s 的形式
-	string d = subtract(n, "1");
-	int s = 0;
-	while ((d.back() - '0') % 2 == 0) {
-		d = divide_by_2(d);
-		s++;
-	}
-	
-	// 测试不同的基
-	for (int base : bases) {
-		if (base == 0) continue;
-		
-		string base_str = to_string(base);
-		// 如果基大于等于n，跳过
-		if (compare(base_str, n) >= 0) continue;
-		
-		string x = power_mod(base_str, d, n);
-		
-		if (x == "1" || x == subtract(n, "1")) {
-			continue;
-		}
-		
-		bool composite = true;
-		string x_temp = x;
-		for (int r = 0; r < s; r++) {
-			x_temp = multiply_mod(x_temp, x_temp, n);
-			if (x_temp == subtract(n, "1")) {
-				composite = false;
-				break;
-			}
-		}
-		
-		if (composite) {
-			return false;
-		}
-	}
-	
-	return true;
-}
-
-// ==================== 生成随机质数 ====================
-
-// 检查是否能被小质数整除（快速排除非质数）
-bool divisible_by_small_primes(const string& n) {
-	int small_primes[] = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47};
-	
-	// 检查偶数
-	if ((n.back() - '0') % 2 == 0) return true;
-	
-	// 检查其他小质数
-	for (int prime : small_primes) {
-		if (mod(n, prime) == 0) {
-			return true;
-		}
-	}
-	
-	return false;
-}
-
-// 生成一个随机质数（指定位数）
-string generate_random_prime(int digits, int max_attempts = 100) {
-	if (digits <= 0) return "2";
-	if (digits == 1) {
-		// 一位数的质数：2, 3, 5, 7
-		int primes[] = {2, 3, 5, 7};
-		return to_string(primes[rng() % 4]);
-	}
-	
-	int attempts = 0;
-	while (attempts < max_attempts) {
-		// 生成随机数，确保是奇数（最后一位是奇数）
-		string candidate = generate_random_number(digits);
-		
-		// 确保是奇数
-		if ((candidate.back() - '0') % 2 == 0) {
-			// 如果是偶数，加1变成奇数
-			int last_digit = candidate.back() - '0';
-			candidate.back() = (last_digit == 9) ? '1' : char(last_digit + 1 + '0');
-		}
-		
-		// 快速检查：排除能被小质数整除的数
-		if (divisible_by_small_primes(candidate)) {
-			attempts++;
-			continue;
-		}
-		
-		// 米勒-拉宾测试
-		if (miller_rabin(candidate)) {
-			return candidate;
-		}
-		
-		attempts++;
-	}
-	
-	// 如果没找到，返回一个已知的大质数
-	if (digits <= 20) {
-		// 返回一个较小的已知质数
-		return "1000000000000000003";  // 19位的质数
-	} else {
-		// 返回一个较大的已知质数
-		return "9999999999999999999999999999999999999999999999999999999999999999999999999999999999999999999999999929";
-	}
-}
-
-// ==================== 主函数 ====================
-
-int main() {
-	int choice;
-	cout << "选择操作：" << endl;
-	cout << "1. 判断输入的数是否为质数" << endl;
-	cout << "2. 随机生成一个质数" << endl;
-	cout << "请输入选择 (1 或 2): ";
-	cin >> choice;
-	
-	if (choice == 1) {
-		// 判断输入的数是否为质数
-		string n;
-		cout << "请输入一个大整数（不超过100位）: ";
-		cin >> n;
-		
-		// 移除可能的空格或换行
-		n.erase(remove_if(n.begin(), n.end(), ::isspace), n.end());
-		
-		// 验证输入
-		if (n.length() > 100 || !all_of(n.begin(), n.end(), ::isdigit)) {
-			cout << "输入无效！" << endl;
-			return 1;
-		}
-		
-		// 移除前导零
-		n.erase(0, n.find_first_not_of('0'));
-		if (n.empty()) n = "0";
-		
-		// 检查是否为质数
-		cout << "测试中，请稍候..." << endl;
-		if (miller_rabin(n)) {
-			cout << n << " 是质数" << endl;
-		} else {
-			cout << n << " 不是质数" << endl;
-		}
-	} else if (choice == 2) {
-		// 随机生成质数
-		int digits;
-		cout << "请输入要生成的质数的位数 (1-100): ";
-		cin >> digits;
-		
-		if (digits < 1 || digits > 100) {
-			cout << "位数必须在1到100之间！" << endl;
-			return 1;
-		}
-		
-		cout << "正在生成 " << digits << " 位的随机质数..." << endl;
-		cout << "这可能需要一些时间，请耐心等待..." << endl;
-		
-		string prime = generate_random_prime(digits);
-		
-		cout << "\n生成的质数为：" << endl;
-		cout << prime << endl;
-		
-		// 验证一下（可选）
-		cout << "\n验证中..." << endl;
-		if (miller_rabin(prime)) {
-			cout << "验证通过：这是一个质数" << endl;
-		} else {
-			cout << "警告：生成的数可能不是质数！" << endl;
-		}
-		cout << "位数：" << prime.length() << endl;
-	} else {
-		cout << "无效的选择！" << endl;
-		return 1;
-	}
-	return 0;
-}
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <chrono>
+#include <stdlib.h>
+#include <cctype>
+#include <functional>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <fstream>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <climits>
+#include <numeric>
+#include <unordered_map>
+#include <unordered_set>
+#include "bigint.h"
+#include "bigbin.h"
+#include "primetable.h"
+
+using namespace std;
+using hpcore::BigUInt;
+using hpcore::MontContext;
+using hpcore::MontNum;
+using hpcore::SmallModuli;
+using hpcore::PrimeTable;
+
+// ==================== 函数声明 ====================
+BigUInt mod_big(const BigUInt& a, const BigUInt& n);
+BigUInt multiply_mod(const BigUInt& a, const BigUInt& b, const BigUInt& n);
+BigUInt power_mod(const BigUInt& a, const BigUInt& b, const BigUInt& n);
+bool miller_rabin(const BigUInt& n);
+bool miller_rabin_u64(uint64_t n);
+bool is_prime(const BigUInt& n);
+uint32_t inverse_mod_u32(uint32_t a, uint32_t p);
+const vector<uint32_t>& sieve_primes();
+const SmallModuli& sieving_moduli(uint64_t bound);
+void submit_split_task(function<void()> task);
+
+// ==================== 随机数生成器 ====================
+mt19937 rng(chrono::steady_clock::now().time_since_epoch().count());
+
+// 均匀随机取 [0, bound) 中的整数：按 limb 成块生成，超出则整块重抽
+// （gen 默认为全局随机数；多线程时每个线程传入自己的随机数流）
+BigUInt random_below(const BigUInt& bound, mt19937& gen = rng) {
+	size_t bits = bound.bit_length();
+	vector<uint64_t> limbs((bits + 63) / 64);
+	while (true) {
+		for (uint64_t& limb : limbs) limb = ((uint64_t)gen() << 32) | gen();
+		if (bits % 64) limbs.back() &= (1ULL << (bits % 64)) - 1;
+		BigUInt x = BigUInt::from_limbs(limbs);
+		if (x < bound) return x;
+	}
+}
+
+// ==================== 大整数运算（共享核心 bigint.h） ====================
+
+// 大整数取模（模一个大整数）
+BigUInt mod_big(const BigUInt& a, const BigUInt& n) {
+	PROF_SCOPE("mod_big", a.size());
+	if (a < n) return a;
+	return a % n;
+}
+
+// 大整数乘法取模 (a * b) % n
+BigUInt multiply_mod(const BigUInt& a, const BigUInt& b, const BigUInt& n) {
+	PROF_SCOPE("multiply_mod", n.size());
+	return mod_big(a * b, n);
+}
+
+// 滑动窗口宽度：按指数比特数选取，窗口越宽乘法越少，但奇数次幂表（2^(w-1) 项）的预计算越贵
+int window_bits(size_t exp_bits) {
+	if (exp_bits > 671) return 6;
+	if (exp_bits > 239) return 5;
+	if (exp_bits > 79) return 4;
+	if (exp_bits > 23) return 3;
+	return 1;
+}
+
+// 蒙哥马利形式下的快速幂：base 和返回值都是 Montgomery 形式
+// 从高位到低位滑动窗口：每个窗口以1结尾、宽度不超过 w，窗口内的值一定是奇数，查预计算的奇数次幂表
+// cancel 非空时每个窗口检查一次，被置位就提前返回（结果无意义，由调用方丢弃）
+MontNum mont_power(const MontContext& ctx, const MontNum& base, const BigUInt& e, const atomic<bool>* cancel = nullptr) {
+	size_t bits = e.bit_length();
+	if (bits == 0) return ctx.one();
+	
+	// table[i] = base^(2i+1)
+	int w = window_bits(bits);
+	vector<MontNum> table(size_t(1) << (w - 1));
+	table[0] = base;
+	if (w > 1) {
+		MontNum base_sq;
+		ctx.sqr(base_sq, base);
+		for (size_t i = 1; i < table.size(); i++) ctx.mul(table[i], table[i - 1], base_sq);
+	}
+	
+	MontNum result;
+	bool started = false;
+	long i = (long)bits - 1;
+	while (i >= 0) {
+		if (cancel && cancel->load(memory_order_relaxed)) break;
+		if (!e.test_bit(i)) {
+			ctx.sqr(result, result);
+			i--;
+			continue;
+		}
+		// 窗口 e[i..j]：最低位 j 取在 i-w+1 之后第一个1上
+		long j = max(i - w + 1, 0L);
+		while (!e.test_bit(j)) j++;
+		size_t val = 0;
+		for (long b = i; b >= j; b--) val = val * 2 + e.test_bit(b);
+		if (started) {
+			for (long b = i; b >= j; b--) ctx.sqr(result, result);
+			ctx.mul(result, result, table[val >> 1]);
+		} else {
+			// 最高位一定是1，第一个窗口直接取表项，省掉前面对1的平方
+			result = table[val >> 1];
+			started = true;
+		}
+		i = j - 1;
+	}
+	return result;
+}
+
+// 2^e 的 Montgomery 形式：底数为2时乘底数就是模加倍，从高到低每位一次平方、为1时再加倍，
+// 省掉滑动窗口的奇数次幂表和窗口乘法（4096 位指数约少六百次模乘）；最高的几位直接合成 2^v 转入
+MontNum mont_power_of_two(const MontContext& ctx, const BigUInt& e, const atomic<bool>* cancel = nullptr) {
+	size_t bits = e.bit_length();
+	if (bits == 0) return ctx.one();
+	long i = (long)bits - 1;
+	uint64_t v = 0;
+	for (int taken = 0; taken < 6 && i >= 0; taken++, i--) v = v * 2 + e.test_bit(i);
+	MontNum result = ctx.to_mont(BigUInt(1ULL << v));
+	for (; i >= 0; i--) {
+		if (cancel && cancel->load(memory_order_relaxed)) break;
+		ctx.sqr(result, result);
+		if (e.test_bit(i)) ctx.add(result, result, result);
+	}
+	return result;
+}
+
+// 快速幂取模 (a^b mod n)
+BigUInt power_mod(const BigUInt& a, const BigUInt& b, const BigUInt& n) {
+	PROF_SCOPE("power_mod", n.size());
+	if (n.is_one()) return BigUInt(0);
+	if (n.is_odd()) {
+		MontContext ctx(n);
+		return ctx.from_mont(mont_power(ctx, ctx.to_mont(a), b));
+	}
+	
+	// 偶数模不能用 Montgomery，退回普通的平方-乘
+	BigUInt result(1), x = mod_big(a, n);
+	for (size_t i = b.bit_length(); i-- > 0;) {
+		result = multiply_mod(result, result, n);
+		if (b.test_bit(i)) result = multiply_mod(result, x, n);
+	}
+	return result;
+}
+
+// ==================== 64位原生快速路径 ====================
+// n < 2^64 时全部在 uint64_t 上运算，不经过多精度整数：
+// 单limb Montgomery 乘法（128位乘积取高位，无除法）加已证明的确定性基集合
+
+// 64位 Montgomery 上下文，要求 n 为奇数
+struct Mont64 {
+	uint64_t n, inv, r1, r2;  // inv = n^(-1) mod 2^64，r1 = R mod n，r2 = R^2 mod n
+	
+	explicit Mont64(uint64_t m) : n(m) {
+		inv = m;
+		for (int i = 0; i < 5; i++) inv *= 2 - m * inv;
+		r1 = (0 - m) % m;
+		r2 = (uint64_t)((unsigned __int128)r1 * r1 % m);
+	}
+	
+	// a·b·R^(-1) mod n：t - m·n 的低64位恰好为0，高位相减不会溢出
+	uint64_t mul(uint64_t a, uint64_t b) const {
+		unsigned __int128 t = (unsigned __int128)a * b;
+		uint64_t m = (uint64_t)t * inv;
+		uint64_t mn_hi = (uint64_t)(((unsigned __int128)m * n) >> 64);
+		uint64_t t_hi = (uint64_t)(t >> 64);
+		return t_hi >= mn_hi ? t_hi - mn_hi : t_hi - mn_hi + n;
+	}
+	
+	uint64_t to_mont(uint64_t a) const { return mul(a % n, r2); }
+	
+	uint64_t power(uint64_t base, uint64_t e) const {
+		uint64_t result = r1;
+		while (e) {
+			if (e & 1) result = mul(result, base);
+			base = mul(base, base);
+			e >>= 1;
+		}
+		return result;
+	}
+};
+
+// 单个基的强伪素数检验，x 为 a^d（Montgomery 形式）
+bool strong_probe_u64(const Mont64& mont, uint64_t x, int s) {
+	uint64_t minus_one = mont.n - mont.r1;
+	if (x == mont.r1 || x == minus_one) return true;
+	for (int r = 1; r < s; r++) {
+		x = mont.mul(x, x);
+		if (x == minus_one) return true;
+	}
+	return false;
+}
+
+// 对 K 个基同时做 a^d：各基的乘法链互不依赖，交错执行可以填满乘法器流水线，
+// 单个基时每次模乘都要等上一次的结果，瓶颈在乘法延迟上
+template <int K>
+bool strong_probes_u64(const Mont64& mont, const uint64_t (&bases)[K], uint64_t d, int s) {
+	uint64_t a[K], x[K];
+	for (int j = 0; j < K; j++) {
+		// 基是 n 的倍数时该基不提供信息，视为通过
+		a[j] = mont.to_mont(bases[j]);
+		x[j] = mont.r1;
+	}
+	for (int i = 63 - __builtin_clzll(d); i >= 0; i--) {
+		for (int j = 0; j < K; j++) x[j] = mont.mul(x[j], x[j]);
+		if ((d >> i) & 1) {
+			for (int j = 0; j < K; j++) x[j] = mont.mul(x[j], a[j]);
+		}
+	}
+	for (int j = 0; j < K; j++) {
+		if (a[j] != 0 && !strong_probe_u64(mont, x[j], s)) return false;
+	}
+	return true;
+}
+
+// 先单独测基2（几乎所有合数在这里就被排除），剩下的基交错执行：
+// 2^32 以下 {2, 7, 61} 即可确定；2^64 以下使用 Sinclair 的7个基 {2, 325, 9375, 28178, 450775, 9780504, 1795265022}
+const uint64_t bases_u32_rest[] = {7, 61};
+const uint64_t bases_u64_rest[] = {325, 9375, 28178, 450775, 9780504, 1795265022};
+
+bool miller_rabin_u64(uint64_t n) {
+	PROF_SCOPE("miller_rabin_u64", 1);
+	const uint64_t small_primes[] = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37};
+	if (n < 2) return false;
+	for (uint64_t p : small_primes) {
+		if (n % p == 0) return n == p;
+	}
+	if (n < 41 * 41) return true;
+	
+	uint64_t d = n - 1;
+	int s = __builtin_ctzll(d);
+	d >>= s;
+	
+	Mont64 mont(n);
+	if (!strong_probe_u64(mont, mont.power(mont.to_mont(2), d), s)) return false;
+	if (n < (1ULL << 32)) return strong_probes_u64(mont, bases_u32_rest, d, s);
+	return strong_probes_u64(mont, bases_u64_rest, d, s);
+}
+
+// ==================== 米勒-拉宾素性测试 ====================
+
+// 前12个素数作为基时，对 n < 318665857834031151167461（约3.2·10^24）是确定性的，再往上存在能通过全部12个基的合数；
+// 更大的数默认用 Baillie-PSW（见下），这里的基数只在需要额外轮次时使用
+const int bases[] = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37};
+const int BASE_COUNT = sizeof(bases) / sizeof(bases[0]);
+
+// 单个大数的测试可以拆给多个线程：各个基（或 Baillie-PSW 的两半和追加的基）互相独立，
+// 同时计算，任何一个判定为合数就通知其余线程在下一个幂窗口处停下。
+// test_threads 为 1 时不拆分（批量模式已经按数并行）；交互模式和 --test-threads 会调大。
+// 太小的数一次测试只有几十微秒，不值得起线程。
+int test_threads = 1;
+const size_t PARALLEL_TEST_MIN_BITS = 1024;
+
+// 依次（或在 threads 个线程上同时）执行 task(0..count-1)，全部返回 true 时结果为 true；
+// 任何一个返回 false 就置位 cancel，其余任务应尽早返回，不再领取新任务
+bool all_tasks_pass(size_t count, int threads, const function<bool(size_t, const atomic<bool>*)>& task) {
+	if (threads <= 1 || count <= 1) {
+		for (size_t i = 0; i < count; i++) {
+			if (!task(i, nullptr)) return false;
+		}
+		return true;
+	}
+	// 辅助任务交给常驻线程池，可能在本次调用返回之后才被取到，所以状态放在共享指针里：
+	// 那时下标已经领完，辅助任务直接退出，不会再碰 task 引用的局部变量
+	struct State {
+		atomic<size_t> next{0};
+		atomic<bool> cancel{false};
+		size_t finished = 0;   // 已做完的任务数，受 m 保护
+		mutex m;
+		condition_variable done;
+	};
+	shared_ptr<State> state = make_shared<State>();
+	auto worker = [state, count, &task] {
+		for (size_t i; !state->cancel.load() && (i = state->next.fetch_add(1)) < count;) {
+			if (!task(i, &state->cancel)) state->cancel.store(true);
+			lock_guard<mutex> lock(state->m);
+			state->finished++;
+			state->done.notify_all();
+		}
+	};
+	for (size_t i = 1; i < min<size_t>(threads, count); i++) submit_split_task(worker);
+	worker();
+	// 收回剩余下标，之后等已经领走的任务做完
+	size_t claimed = min(state->next.exchange(count), count);
+	unique_lock<mutex> lock(state->m);
+	state->done.wait(lock, [&] { return state->finished == claimed; });
+	return !state->cancel.load();
+}
+
+// n 的比特数够大时拆分单个测试所用的线程数
+int split_threads(const BigUInt& n) {
+	return n.bit_length() >= PARALLEL_TEST_MIN_BITS ? test_threads : 1;
+}
+
+// 单个基 a 的强伪素数检验，n-1 = d·2^s，ctx 为 n 的 Montgomery 上下文
+bool strong_probe(const MontContext& ctx, const BigUInt& a, const BigUInt& d, int s, const atomic<bool>* cancel = nullptr) {
+	const MontNum& one = ctx.one();
+	MontNum minus_one = ctx.neg(one);
+	MontNum x = a == BigUInt(2) ? mont_power_of_two(ctx, d, cancel) : mont_power(ctx, ctx.to_mont(a), d, cancel);
+	if (x == one || x == minus_one) return true;
+	// 再平方 s-1 次，途中出现 n-1 则通过
+	for (int r = 1; r < s; r++) {
+		if (cancel && cancel->load(memory_order_relaxed)) return true;
+		ctx.sqr(x, x);
+		if (x == minus_one) return true;
+	}
+	return false;
+}
+
+// 以 probe_list 中的每个数为基做强伪素数检验（n 为大于 64 位的奇数），按 split_threads 拆给多个线程
+bool strong_probes(const BigUInt& n, const vector<BigUInt>& probe_list) {
+	// 将 n-1 写成 d * 2^s 的形式
+	BigUInt n_minus_1 = n - BigUInt(1);
+	int s = n_minus_1.trailing_zeros();
+	BigUInt d = n_minus_1 >> s;
+	
+	// 所有基和整个平方循环共用同一个 Montgomery 上下文，比较也直接在 Montgomery 形式下进行；
+	// 上下文带乘积暂存区，并行时每个任务用自己的副本
+	MontContext ctx(n);
+	int threads = split_threads(n);
+	return all_tasks_pass(probe_list.size(), threads, [&](size_t i, const atomic<bool>* cancel) {
+		if (threads <= 1) return strong_probe(ctx, probe_list[i], d, s);
+		MontContext local = ctx;
+		return strong_probe(local, probe_list[i], d, s, cancel);
+	});
+}
+
+// rounds 轮米勒-拉宾：前12轮依次用 bases[] 中的素数，超出部分用随机基
+bool miller_rabin(const BigUInt& n, int rounds) {
+	PROF_SCOPE("miller_rabin", n.size());
+	// 64位以内走原生快速路径
+	if (n.fits_u64()) return miller_rabin_u64(n.low_u64());
+	
+	// 检查是否为偶数
+	if (!n.is_odd()) return false;
+	
+	thread_local mt19937_64 base_gen(0x9E3779B97F4A7C15ULL);
+	vector<BigUInt> probe_list;
+	for (int i = 0; i < rounds; i++) {
+		// 随机基取在 [2, 2^64) 中，n 超过64位，不会越界
+		probe_list.push_back(i < BASE_COUNT ? BigUInt(bases[i]) : BigUInt(base_gen() | 2));
+	}
+	return strong_probes(n, probe_list);
+}
+
+bool miller_rabin(const BigUInt& n) {
+	return miller_rabin(n, BASE_COUNT);
+}
+
+// ==================== Baillie-PSW 素性测试 ====================
+// 基2强伪素数检验 + Selfridge 参数的强 Lucas 检验。两者的伪素数几乎不重叠，
+// 至今没有已知反例（2^64 以下已穷举验证），代价约为 3 次米勒-拉宾，而不是 12 次。
+
+// 雅可比符号 (a/n)，n 为正奇数
+int jacobi_u64(uint64_t a, uint64_t n) {
+	int result = 1;
+	a %= n;
+	while (a) {
+		while (a % 2 == 0) {
+			a /= 2;
+			if (n % 8 == 3 || n % 8 == 5) result = -result;
+		}
+		swap(a, n);
+		if (a % 4 == 3 && n % 4 == 3) result = -result;
+		a %= n;
+	}
+	return n == 1 ? result : 0;
+}
+
+// 雅可比符号 (D/n)，D 为小的有符号奇数，n 为大奇数
+int jacobi(int64_t D, const BigUInt& n) {
+	int result = 1;
+	uint64_t a = D < 0 ? (uint64_t)-D : (uint64_t)D;
+	// (-1/n) = (-1)^((n-1)/2)
+	if (D < 0 && n.low_u64() % 4 == 3) result = -result;
+	// 二次互反律：(a/n) = (n/a)·(-1)^((a-1)/2·(n-1)/2)
+	if (a % 4 == 3 && n.low_u64() % 4 == 3) result = -result;
+	return result * jacobi_u64(n.mod_small(a), a);
+}
+
+// 强 Lucas 检验（P = 1，Q = (1-D)/4，D 按 Selfridge 方法 A 取 5, -7, 9, -11, ... 中第一个 (D/n) = -1 的）
+// n+1 = d·2^s，n 是质数时 U_d ≡ 0 或某个 V_{d·2^r} ≡ 0（0 <= r < s）
+// cancel 非空时每一步检查一次，被置位就提前返回（结果无意义）
+bool strong_lucas(const BigUInt& n, const MontContext& ctx, const atomic<bool>* cancel = nullptr) {
+	PROF_SCOPE("strong_lucas", n.size());
+	int64_t D = 5;
+	for (int tries = 0;; tries++) {
+		int j = jacobi(D, n);
+		if (j == -1) break;
+		// |D| 与 n 有公因子
+		if (j == 0 && BigUInt((uint64_t)(D < 0 ? -D : D)) != n) return false;
+		// 完全平方数找不到 (D/n) = -1，试过一些 D 之后检查一次
+		if (tries == 20) {
+			BigUInt r = n.isqrt();
+			if (r * r == n) return false;
+		}
+		D = D > 0 ? -(D + 2) : -D + 2;
+	}
+	int64_t Q = (1 - D) / 4;
+	
+	auto signed_mont = [&](int64_t x) {
+		MontNum m = ctx.to_mont(BigUInt((uint64_t)(x < 0 ? -x : x)));
+		return x < 0 ? ctx.neg(m) : m;
+	};
+	MontNum Dm = signed_mont(D), Qm = signed_mont(Q);
+	
+	BigUInt n_plus_1 = n + BigUInt(1);
+	int s = (int)n_plus_1.trailing_zeros();
+	BigUInt d = n_plus_1 >> s;
+	
+	// 从 k = 1 开始：U_1 = 1，V_1 = P = 1，Q^1 = Q；按 d 的比特从高到低倍增，遇到1再加一
+	MontNum U = ctx.one(), V = ctx.one(), Qk = Qm, t;
+	for (size_t i = d.bit_length() - 1; i-- > 0;) {
+		if (cancel && cancel->load(memory_order_relaxed)) return true;
+		// U_2k = U_k·V_k，V_2k = V_k^2 - 2Q^k
+		ctx.mul(U, U, V);
+		ctx.sqr(V, V);
+		ctx.sub(V, V, Qk);
+		ctx.sub(V, V, Qk);
+		ctx.sqr(Qk, Qk);
+		if (d.test_bit(i)) {
+			// U_{k+1} = (P·U + V)/2，V_{k+1} = (D·U + P·V)/2
+			ctx.mul(t, Dm, U);
+			ctx.add(U, U, V);
+			ctx.half(U, U);
+			ctx.add(V, t, V);
+			ctx.half(V, V);
+			ctx.mul(Qk, Qk, Qm);
+		}
+	}
+	if (MontContext::is_zero(U) || MontContext::is_zero(V)) return true;
+	for (int r = 1; r < s; r++) {
+		ctx.sqr(V, V);
+		ctx.sub(V, V, Qk);
+		ctx.sub(V, V, Qk);
+		if (MontContext::is_zero(V)) return true;
+		ctx.sqr(Qk, Qk);
+	}
+	return false;
+}
+
+// extra 中的数作为额外的米勒-拉宾基，与两半一起检验；拆分时所有任务同时算
+bool baillie_psw(const BigUInt& n, const vector<BigUInt>& extra = {}) {
+	PROF_SCOPE("baillie_psw", n.size());
+	if (n.fits_u64()) return miller_rabin_u64(n.low_u64());
+	if (!n.is_odd()) return false;
+	// 先用 1000 以下的奇素数排除，省掉大部分合数的幂运算（多模数一遍扫描，开销远小于一次模幂）
+	static const size_t screen_count = lower_bound(sieve_primes().begin(), sieve_primes().end(), 1000u) - sieve_primes().begin();
+	if (sieving_moduli(1000).divides_any(n, screen_count)) return false;
+	
+	BigUInt n_minus_1 = n - BigUInt(1);
+	int s = n_minus_1.trailing_zeros();
+	BigUInt d = n_minus_1 >> s;
+	MontContext ctx(n);
+	int threads = split_threads(n);
+	// 任务 0 是基2强伪素数检验，任务 1 是强 Lucas 检验，其后是各个额外的基；不拆分时按这个顺序依次做
+	auto task = [&](size_t i, const atomic<bool>* cancel) {
+		if (threads <= 1) return i == 1 ? strong_lucas(n, ctx) : strong_probe(ctx, i == 0 ? BigUInt(2) : extra[i - 2], d, s);
+		// 并行时每个任务用自己的上下文副本
+		MontContext local = ctx;
+		return i == 1 ? strong_lucas(n, local, cancel) : strong_probe(local, i == 0 ? BigUInt(2) : extra[i - 2], d, s, cancel);
+	};
+	return all_tasks_pass(2 + extra.size(), threads, task);
+}
+
+// ==================== 特殊形式：Lucas-Lehmer、Proth 与 LLR ====================
+// N = k·2^n ± 1（k 为奇数且 k < 2^n）有确定性的判定方法，每步只是一次平方加一次廉价约简：
+//   梅森数 2^p - 1：Lucas-Lehmer，s0 = 4，s ← s^2 - 2 共 p-2 次，N 为质数当且仅当结果为0；
+//   k·2^n + 1：Proth 定理，取 (a/N) = -1 的 a，N 为质数当且仅当 a^((N-1)/2) ≡ -1；
+//   k·2^n - 1：LLR（Rödseth 判据），取 (P-2/N) = 1、(P+2/N) = -1 的 P，u0 = V_k(P, 1)，
+//   u ← u^2 - 2 共 n-2 次，N 为质数当且仅当结果为0。
+// 约简利用 k·2^n ≡ -c (mod N)：x = hi·2^n + lo，hi = q·k + r，则 x ≡ r·2^n + lo - c·q，
+// 只需移位、加减和一次单limb除法；平方走 Karatsuba。指数很大时比通用的 Montgomery（REDC 是 n^2 的）快得多。
+
+// N = k·2^n + c，c = ±1
+struct SpecialForm {
+	uint64_t k = 1;
+	uint64_t n = 0;
+	int c = -1;
+	
+	BigUInt value() const {
+		BigUInt v = BigUInt(k) << n;
+		return c > 0 ? v + BigUInt(1) : v - BigUInt(1);
+	}
+	
+	// k·2^n±1 的比特数，不构造数本身（k 为奇数、n >= 1：只有 2^n-1 比 k·2^n 少一位）
+	uint64_t bit_length() const {
+		return (uint64_t)(64 - __builtin_clzll(k)) + n - (c < 0 && k == 1);
+	}
+	
+	string to_string() const {
+		return (k == 1 ? string() : std::to_string(k) + "*") + "2^" + std::to_string(n) + (c > 0 ? "+1" : "-1");
+	}
+};
+
+// 指数上限：再大的数一次平方就要几百MB
+const uint64_t SPECIAL_FORM_MAX_EXPONENT = 1ULL << 32;
+
+// 解析 2^p-1、k*2^n+1、k·2^n-1 形式的表达式（不含空白；k 省略时为1，k 为偶数时把因子2并入指数）
+bool parse_special_form(const string& s, SpecialForm& f) {
+	size_t pos = s.find("2^");
+	if (pos == string::npos || s.size() < pos + 5) return false;
+	string prefix = s.substr(0, pos);
+	uint64_t k = 1;
+	if (!prefix.empty()) {
+		size_t len = prefix.size();
+		if (prefix.back() == '*') {
+			len -= 1;
+		} else if (len >= 2 && prefix.compare(len - 2, 2, "\xC2\xB7") == 0) {
+			len -= 2;  // UTF-8 的 ·
+		} else {
+			return false;
+		}
+		auto [end, ec] = from_chars(prefix.data(), prefix.data() + len, k);
+		if (ec != errc() || end != prefix.data() + len || len == 0 || k == 0) return false;
+	}
+	const char *first = s.data() + pos + 2, *last = s.data() + s.size() - 2;
+	uint64_t n = 0;
+	auto [end, ec] = from_chars(first, last, n);
+	if (ec != errc() || end != last || first == last) return false;
+	string tail = s.substr(s.size() - 2);
+	if (tail != "+1" && tail != "-1") return false;
+	
+	int shift = __builtin_ctzll(k);
+	k >>= shift;
+	n += shift;
+	if (n == 0 || n > SPECIAL_FORM_MAX_EXPONENT) return false;
+	f.k = k;
+	f.n = n;
+	f.c = tail[0] == '+' ? 1 : -1;
+	return true;
+}
+
+// n = k·2^m ± 1（k 为奇数、k < 2^m 且不超过64位）时填好 f 并返回 true
+bool detect_special_form(const BigUInt& n, SpecialForm& f) {
+	for (int c : {1, -1}) {
+		BigUInt t = c > 0 ? n - BigUInt(1) : n + BigUInt(1);
+		size_t m = t.trailing_zeros(), k_bits = t.bit_length() - m;
+		if (k_bits > 64 || k_bits > m) continue;
+		f.k = (t >> m).low_u64();
+		f.n = m;
+		f.c = c;
+		return true;
+	}
+	return false;
+}
+
+// 模 N = k·2^n + c 的快速约简
+class SpecialModulus {
+private:
+	BigUInt N;
+	uint64_t k;
+	size_t n;
+	int c;
+
+public:
+	explicit SpecialModulus(const SpecialForm& f) : N(f.value()), k(f.k), n(f.n), c(f.c) {}
+	
+	const BigUInt& modulus() const { return N; }
+	
+	// x mod N（x < N^2）：每轮把 x 缩到不超过 N + x/N，两三轮即落到 2^(N 的比特数+1) 以下（小于 4N），最后至多减三次 N。
+	// 折叠只在 x 至少有 N 的比特数加一位时做：再小时不一定变小（c = -1 时 x = N 折叠后仍是 N）
+	BigUInt reduce(BigUInt x) const {
+		size_t fold_bits = N.bit_length() + 1;
+		while (x.bit_length() > fold_bits) {
+			BigUInt q = x >> n, t = x.low_bits(n);
+			uint64_t r = q.divmod_small(k);
+			t += BigUInt(r) << n;
+			if (c < 0) {
+				t += q;
+			} else {
+				while (t < q) t += N;
+				t -= q;
+			}
+			x = move(t);
+		}
+		while (x >= N) x -= N;
+		return x;
+	}
+	
+	BigUInt mul(const BigUInt& a, const BigUInt& b) const { return reduce(a * b); }
+	BigUInt sqr(const BigUInt& a) const { return reduce(a.sqr()); }
+	
+	// (a - s) mod N，a < N
+	BigUInt sub_small(const BigUInt& a, uint64_t s) const {
+		BigUInt b(s);
+		return a >= b ? a - b : a + N - b;
+	}
+	
+	// a^e mod N
+	BigUInt pow(const BigUInt& a, uint64_t e) const {
+		BigUInt r(1);
+		for (int i = 63 - __builtin_clzll(e | 1); i >= 0; i--) {
+			r = sqr(r);
+			if ((e >> i) & 1) r = mul(r, a);
+		}
+		return r;
+	}
+};
+
+// 梅森数 2^p - 1（p > 64）
+bool lucas_lehmer(uint64_t p) {
+	PROF_SCOPE("lucas_lehmer", p / 64);
+	// 指数是合数时 2^p - 1 也是合数
+	if (!miller_rabin_u64(p)) return false;
+	SpecialForm f;
+	f.n = p;
+	SpecialModulus mod(f);
+	BigUInt s(4);
+	for (uint64_t i = 0; i + 2 < p; i++) s = mod.sub_small(mod.sqr(s), 2);
+	return s.is_zero();
+}
+
+// k·2^n + 1（k < 2^n）
+bool proth_test(const SpecialForm& f) {
+	PROF_SCOPE("proth_test", f.n / 64);
+	SpecialModulus mod(f);
+	const BigUInt& N = mod.modulus();
+	uint64_t a = 0;
+	for (uint32_t p : sieve_primes()) {
+		int j = jacobi(p, N);
+		if (j == 0) return false;  // N 有小因子 p（N 远大于 p）
+		if (j == -1) {
+			a = p;
+			break;
+		}
+	}
+	// 只有完全平方数才找不到二次非剩余
+	if (a == 0) return N.isqrt().sqr() != N && baillie_psw(N);
+	BigUInt x = mod.pow(BigUInt(a), f.k);
+	for (uint64_t i = 1; i < f.n; i++) x = mod.sqr(x);
+	return x == N - BigUInt(1);
+}
+
+// k·2^n - 1（k 为大于1的奇数，k < 2^n，n >= 3）
+bool llr_test(const SpecialForm& f) {
+	PROF_SCOPE("llr_test", f.n / 64);
+	SpecialModulus mod(f);
+	const BigUInt& N = mod.modulus();
+	// N ≡ 7 (mod 8) 不是完全平方数，这样的 P 一定存在
+	uint64_t P = 3;
+	for (;; P += 2) {
+		int j1 = jacobi((int64_t)P - 2, N), j2 = jacobi((int64_t)P + 2, N);
+		if (j1 == 0 || j2 == 0) return false;
+		if (j1 == 1 && j2 == -1) break;
+	}
+	// Lucas 链求 V_k(P, 1)：(V_m, V_{m+1}) 按 k 的二进制位逐位翻倍
+	BigUInt v0(2), v1(P);
+	for (int i = 63 - __builtin_clzll(f.k); i >= 0; i--) {
+		if ((f.k >> i) & 1) {
+			v0 = mod.sub_small(mod.mul(v0, v1), P);
+			v1 = mod.sub_small(mod.sqr(v1), 2);
+		} else {
+			v1 = mod.sub_small(mod.mul(v0, v1), P);
+			v0 = mod.sub_small(mod.sqr(v0), 2);
+		}
+	}
+	BigUInt u = move(v0);
+	for (uint64_t i = 0; i + 2 < f.n; i++) u = mod.sub_small(mod.sqr(u), 2);
+	return u.is_zero();
+}
+
+// 特殊形式的确定性判定；数在64位以内或不满足 k < 2^n 时退回一般判定
+bool special_form_is_prime(const SpecialForm& f) {
+	BigUInt N = f.value();
+	if (N.fits_u64()) return miller_rabin_u64(N.low_u64());
+	if (f.n < 64 && (f.k >> f.n) != 0) return baillie_psw(N);
+	if (f.c > 0) return proth_test(f);
+	if (f.k == 1) return lucas_lehmer(f.n);
+	return llr_test(f);
+}
+
+// 默认的素性判定：64位以内确定性米勒-拉宾；k·2^m ± 1（k < 2^m）形式的数用上面的确定性检验；
+// 其余更大的用 Baillie-PSW，再按 extra_mr_rounds 追加随机基的米勒-拉宾（命令行 --mr-rounds 设置）
+int extra_mr_rounds = 0;
+
+bool is_prime(const BigUInt& n) {
+	if (n.fits_u64()) {
+		// 预计算素数表覆盖的范围直接查位图
+		uint64_t v = n.low_u64();
+		const PrimeTable* table = hpcore::default_prime_table();
+		if (table && v < table->limit()) return table->is_prime(v);
+		return miller_rabin_u64(v);
+	}
+	SpecialForm form;
+	if (detect_special_form(n, form)) return special_form_is_prime(form);
+	if (extra_mr_rounds <= 0) return baillie_psw(n);
+	
+	thread_local mt19937_64 base_gen(0xD1B54A32D192ED03ULL);
+	vector<BigUInt> probe_list;
+	for (int i = 0; i < extra_mr_rounds; i++) probe_list.push_back(BigUInt(base_gen() | 2));
+	return baillie_psw(n, probe_list);
+}
+
+// ==================== 生成随机质数 ====================
+
+// [3, limit) 中的奇素数：只存奇数的埃氏筛（下标 i 表示 2i+1），没有预计算素数表时现场生成筛选用的素数
+vector<uint32_t> eratosthenes_odd_primes(uint32_t limit) {
+	const uint32_t half = limit / 2;
+	vector<char> composite(half, 0);
+	vector<uint32_t> result;
+	for (uint32_t i = 1; i < half; i++) {
+		if (composite[i]) continue;
+		uint64_t p = 2 * (uint64_t)i + 1;
+		result.push_back((uint32_t)p);
+		for (uint64_t j = p * p / 2; j < half; j += p) composite[j] = 1;
+	}
+	return result;
+}
+
+// 筛选用的小奇素数（3 到 2^16 之间，共6541个），首次使用时从预计算素数表取，没有素数表时用埃氏筛生成
+const uint32_t SIEVE_PRIME_LIMIT = 1 << 16;
+// 每个窗口最多的奇数候选个数（覆盖 2*SIEVE_WINDOW 的整数区间）
+const size_t SIEVE_WINDOW = 4096;
+
+const vector<uint32_t>& sieve_primes() {
+	static const vector<uint32_t> primes = [] {
+		const PrimeTable* table = hpcore::default_prime_table();
+		if (table && table->moduli_limit() >= SIEVE_PRIME_LIMIT) return table->odd_primes_below(SIEVE_PRIME_LIMIT);
+		return eratosthenes_odd_primes(SIEVE_PRIME_LIMIT);
+	}();
+	return primes;
+}
+
+// 1024 位以上的候选筛得更深（小于 2^21 的奇素数，共约15.6万个）：
+// 米勒-拉宾的代价随比特数近似立方增长，而求小素数余数只是线性的，多筛掉的候选远比多求的余数值钱
+const uint32_t DEEP_SIEVE_PRIME_LIMIT = 1 << 21;
+
+const vector<uint32_t>& deep_sieve_primes() {
+	static const vector<uint32_t> primes = [] {
+		const PrimeTable* table = hpcore::default_prime_table();
+		if (table && table->moduli_limit() >= DEEP_SIEVE_PRIME_LIMIT) return table->odd_primes_below(DEEP_SIEVE_PRIME_LIMIT);
+		return eratosthenes_odd_primes(DEEP_SIEVE_PRIME_LIMIT);
+	}();
+	return primes;
+}
+
+// 4096 位及以上再深一档（小于 2^25 的奇素数，共约206万个）。没有预计算素数表时现场筛选并分组求逆约需0.3秒，
+// 只有单次测试几十毫秒的规模才摊得开；4096 位时比筛到 2^20 少测约18%的候选，再往上多求的余数就抵掉了省下的测试
+const uint32_t HUGE_SIEVE_PRIME_LIMIT = 1 << 25;
+const size_t HUGE_SIEVE_MIN_BITS = 4096;
+
+const vector<uint32_t>& huge_sieve_primes() {
+	static const vector<uint32_t> primes = [] {
+		const PrimeTable* table = hpcore::default_prime_table();
+		if (table && table->limit() >= HUGE_SIEVE_PRIME_LIMIT) return table->odd_primes_below(HUGE_SIEVE_PRIME_LIMIT);
+		return eratosthenes_odd_primes(HUGE_SIEVE_PRIME_LIMIT);
+	}();
+	return primes;
+}
+
+// 比特数为 bits 的候选用多大的素数筛：1024 位及以下取 bits^2（不超过 2^16）；
+// 更大的数取 bits^3/2048（不超过 2^21），4096 位起取 2^25。一次测试的代价约与 bits^3 成正比，
+// 对每个小素数求余数的代价与 bits 成正比，两者平衡处的上界也约随 bits^3 增长
+uint64_t sieve_bound(size_t bits) {
+	uint64_t square = (uint64_t)bits * bits;
+	if (bits <= 1024) return min<uint64_t>(SIEVE_PRIME_LIMIT, max<uint64_t>(256, square));
+	if (bits >= HUGE_SIEVE_MIN_BITS) return HUGE_SIEVE_PRIME_LIMIT;
+	return min<uint64_t>(DEEP_SIEVE_PRIME_LIMIT, square * bits / 2048);
+}
+
+// 覆盖 bound 以下全部奇素数的素数表
+const vector<uint32_t>& sieving_primes(uint64_t bound) {
+	if (bound > DEEP_SIEVE_PRIME_LIMIT) return huge_sieve_primes();
+	return bound > SIEVE_PRIME_LIMIT ? deep_sieve_primes() : sieve_primes();
+}
+
+// 覆盖 bound 以下全部奇素数的多模数余数器，与素数表一样在首次使用时建好；
+// 深筛的约15.6万个模数分组求逆较慢，预计算素数表里恰好存有同一组时直接取现成的
+const SmallModuli& sieving_moduli(uint64_t bound) {
+	if (bound > DEEP_SIEVE_PRIME_LIMIT) {
+		static const SmallModuli huge(huge_sieve_primes());
+		return huge;
+	}
+	if (bound > SIEVE_PRIME_LIMIT) {
+		static const SmallModuli deep = [] {
+			const PrimeTable* table = hpcore::default_prime_table();
+			if (table && table->moduli_limit() == DEEP_SIEVE_PRIME_LIMIT) return table->moduli();
+			return SmallModuli(deep_sieve_primes());
+		}();
+		return deep;
+	}
+	static const SmallModuli small(sieve_primes());
+	return small;
+}
+
+// 搜索过程的统计（基准测试用）：当前线程的 search_stats 非空时，sieve_search 记录每个候选的去向和每次素性测试的耗时
+struct SearchStats {
+	uint64_t sieved = 0;        // 被小素数筛掉的候选
+	uint64_t rejected = 0;      // 通过筛选、但素性测试判为合数的候选
+	vector<double> test_ns;     // 每次素性测试的耗时（纳秒），次数即通过筛选的候选数
+};
+thread_local SearchStats* search_stats = nullptr;
+
+// 计时并记入 search_stats 的素性测试
+bool recorded_is_prime(const BigUInt& n) {
+	auto t0 = chrono::steady_clock::now();
+	bool prime = is_prime(n);
+	search_stats->test_ns.push_back(chrono::duration<double, nano>(chrono::steady_clock::now() - t0).count());
+	if (!prime) search_stats->rejected++;
+	return prime;
+}
+
+// 从奇数 start 开始按窗口向上搜索第一个质数，越过 limit（不含）仍未找到则返回 false
+// 每个小素数 p 只在开始时对 start 取一次模，之后窗口每右移一次余数加上窗口跨度即可；
+// 筛掉所有含小因子的候选后，只对幸存者做米勒-拉宾测试
+// stop 非空时每个窗口、每次米勒-拉宾之前检查一次，被置位即放弃搜索
+bool sieve_search(BigUInt start, const BigUInt& limit, BigUInt& found, const atomic<bool>* stop = nullptr) {
+	PROF_SCOPE("sieve_search", start.size());
+	// 数越小米勒-拉宾越便宜，筛选上界和窗口都随比特数缩小（质数间隔约为 0.69*比特数）
+	size_t bits = start.bit_length();
+	uint64_t bound = sieve_bound(bits);
+	const vector<uint32_t>& primes = sieving_primes(bound);
+	size_t window = min(SIEVE_WINDOW, max<size_t>(256, 2 * bits));
+	// 只用小于 start 的素数筛，否则候选可能恰好就是这个素数本身
+	if (start.fits_u64()) bound = min(bound, start.low_u64());
+	size_t prime_count = lower_bound(primes.begin(), primes.end(), bound) - primes.begin();
+	
+	vector<uint32_t> residue(prime_count);
+	sieving_moduli(bound).residues(start, residue.data(), prime_count);
+	
+	vector<char> composite(window);
+	while (start < limit) {
+		if (stop && stop->load(memory_order_relaxed)) return false;
+		fill(composite.begin(), composite.end(), 0);
+		for (size_t k = 0; k < prime_count; k++) {
+			uint32_t p = primes[k], r = residue[k];
+			// 候选 start + 2i 被 p 整除 <=> 2i ≡ -r (mod p)
+			uint32_t i = r == 0 ? 0 : ((p - r) % 2 == 0 ? (p - r) / 2 : (2 * p - r) / 2);
+			for (; i < window; i += p) composite[i] = 1;
+			residue[k] = (uint32_t)((r + 2 * window) % p);
+		}
+		for (size_t i = 0; i < window; i++) {
+			if (composite[i]) {
+				if (search_stats) search_stats->sieved++;
+				continue;
+			}
+			BigUInt candidate = start + BigUInt(2 * i);
+			if (candidate >= limit) return false;
+			if (stop && stop->load(memory_order_relaxed)) return false;
+			if (search_stats ? recorded_is_prime(candidate) : is_prime(candidate)) {
+				found = candidate;
+				return true;
+			}
+		}
+		start += BigUInt(2 * window);
+	}
+	return false;
+}
+
+// [lo, hi) 中的随机质数（lo >= 3）：随机奇数起点向上做筛选搜索，走出区间就换起点，被 stop 取消时返回 false
+bool random_prime_in(const BigUInt& lo, const BigUInt& hi, mt19937& gen, BigUInt& prime, const atomic<bool>* stop = nullptr) {
+	while (!(stop && stop->load(memory_order_relaxed))) {
+		BigUInt start = lo + random_below(hi - lo, gen);
+		if (!start.is_odd()) start += BigUInt(1);
+		if (sieve_search(start, hi, prime, stop)) return true;
+	}
+	return false;
+}
+
+// d 位十进制数的区间 [10^(d-1), 10^d)
+void decimal_range(int digits, BigUInt& lo, BigUInt& hi) {
+	lo = BigUInt::pow(BigUInt(10), digits - 1);
+	hi = lo * BigUInt(10);
+}
+
+// bits 位且最高两位都是1的区间 [3·2^(bits-2), 2^bits)：两个这样的数相乘恰好是 2·bits 位（RSA 的惯例）
+void bit_range(int bits, BigUInt& lo, BigUInt& hi) {
+	lo = BigUInt(3) << (bits - 2);
+	hi = BigUInt(1) << bits;
+}
+
+// 用 gen 生成一个指定位数的随机质数，被 stop 取消时返回 false
+bool random_prime(int digits, mt19937& gen, BigUInt& prime, const atomic<bool>* stop = nullptr) {
+	if (digits <= 1) {
+		// 一位数的质数：2, 3, 5, 7
+		int primes[] = {2, 3, 5, 7};
+		prime = BigUInt(primes[gen() % 4]);
+		return true;
+	}
+	BigUInt lo, hi;
+	decimal_range(digits, lo, hi);
+	return random_prime_in(lo, hi, gen, prime, stop);
+}
+
+// 生成一个随机质数（指定位数）
+string generate_random_prime(int digits) {
+	if (digits <= 0) return "2";
+	BigUInt prime;
+	random_prime(digits, rng, prime);
+	return prime.to_string();
+}
+
+// ==================== 多线程生成随机质数 ====================
+
+// threads <= 0 表示使用全部核心
+int worker_count(int threads) {
+	if (threads > 0) return threads;
+	unsigned hc = thread::hardware_concurrency();
+	return hc ? (int)hc : 1;
+}
+
+// 单个生成任务：用给定随机数流找一个结果（质数，或质数连同证书），被 stop 取消时返回 false
+template <class Result>
+using ResultFinder = function<bool(mt19937&, Result&, const atomic<bool>*)>;
+
+// 多线程跑 find_one，凑满 count 个结果，每得到一个就调用一次 sink（串行调用，按完成顺序）
+// 每个线程用独立的随机数流（种子取自全局 rng，固定 rng 的种子即可复现），从各自的随机起点搜索；
+// 找到的结果先到先得地占用名额，名额用完后置位 stop，其余线程在下一个窗口或下一次素性测试之前退出。
+// count 小于线程数时（例如只要一个质数）所有线程仍然一起搜索，谁先找到用谁的。
+template <class Result>
+void parallel_generate(long long count, const ResultFinder<Result>& find_one, const function<void(const Result&)>& sink, int threads) {
+	if (count <= 0) return;
+	int n = worker_count(threads);
+	vector<uint32_t> seeds(n);
+	for (uint32_t& seed : seeds) seed = rng();
+	
+	atomic<long long> claimed(0);
+	atomic<bool> stop(false);
+	mutex sink_mutex;
+	auto worker = [&](uint32_t seed) {
+		mt19937 gen(seed);
+		Result result;
+		while (find_one(gen, result, &stop)) {
+			long long slot = claimed.fetch_add(1);
+			if (slot >= count) break;
+			if (slot == count - 1) stop.store(true);
+			lock_guard<mutex> lock(sink_mutex);
+			sink(result);
+		}
+	};
+	
+	vector<thread> pool;
+	for (int i = 1; i < n; i++) pool.emplace_back(worker, seeds[i]);
+	worker(seeds[0]);
+	for (thread& t : pool) t.join();
+}
+
+// 并行生成 count 个指定位数的随机质数
+void generate_random_primes(int digits, long long count, const function<void(const BigUInt&)>& sink, int threads = 0) {
+	parallel_generate<BigUInt>(count, [digits](mt19937& gen, BigUInt& prime, const atomic<bool>* stop) {
+		return random_prime(digits, gen, prime, stop);
+	}, sink, threads);
+}
+
+vector<BigUInt> generate_random_primes(int digits, long long count, int threads = 0) {
+	vector<BigUInt> primes;
+	generate_random_primes(digits, count, [&](const BigUInt& p) { primes.push_back(p); }, threads);
+	return primes;
+}
+
+// ==================== 安全素数与强素数 ====================
+// 安全素数 p = 2q + 1（q 也是质数）比普通质数稀少约百倍，分别测试 p 和 q 太慢：
+// 改为对 q 联合筛选，q 取 ≡ 5 (mod 6) 使 p、q 都不被 2、3 整除，小素数 r 只要整除 q 或 2q+1 就筛掉；
+// 幸存者先做基2费马检查（先 q 后 p），两者都通过才对 q 做完整的 Baillie-PSW。
+// q 为质数时 2^(p-1) ≡ 1 (mod p) 已足以证明 p 是质数（Pocklington：p-1 = 2q，q > sqrt(p)，gcd(2^2-1, p) = 1）。
+//
+// Gordon 强素数：p-1 有大素因子 r，p+1 有大素因子 s，r-1 有大素因子 t，用于抵御 p±1 类分解方法。
+
+enum PrimeKind { PRIME_PLAIN, PRIME_SAFE, PRIME_STRONG };
+
+// 强素数最少的比特数：s、t、r 都要留出足够的长度
+const size_t STRONG_PRIME_MIN_BITS = 128;
+
+// 基2费马检查 2^(n-1) ≡ 1 (mod n)，n 为奇数
+bool fermat_base2(const BigUInt& n) {
+	return power_mod(BigUInt(2), n - BigUInt(1), n).is_one();
+}
+
+// 在等差数列 start + k·step（< limit）上找第一个质数：每个小素数 r 只在开始时求一次 start 的余数和 step 的逆，
+// 被 r 整除的 k 满足 k ≡ -start·step^(-1) (mod r)，之后窗口每右移一次余数加上 window·step 即可
+// accept 非空时用它代替 is_prime 判定幸存者（例如可证明质数构造中的 Pocklington 检查）
+bool progression_search(BigUInt start, const BigUInt& step, const BigUInt& limit, BigUInt& found, const atomic<bool>* stop = nullptr,
+						const function<bool(const BigUInt&)>* accept = nullptr) {
+	PROF_SCOPE("progression_search", start.size());
+	size_t bits = start.bit_length();
+	uint64_t bound = sieve_bound(bits);
+	const vector<uint32_t>& primes = sieving_primes(bound);
+	if (start.fits_u64()) bound = min(bound, start.low_u64());
+	size_t prime_count = lower_bound(primes.begin(), primes.end(), bound) - primes.begin();
+	size_t window = min(SIEVE_WINDOW, max<size_t>(256, 2 * bits));
+
+	vector<uint32_t> residue(prime_count), step_mod(prime_count), step_inv(prime_count), shift(prime_count);
+	const SmallModuli& moduli = sieving_moduli(bound);
+	moduli.residues(start, residue.data(), prime_count);
+	moduli.residues(step, step_mod.data(), prime_count);
+	for (size_t k = 0; k < prime_count; k++) {
+		uint32_t p = primes[k], sm = step_mod[k];
+		step_inv[k] = sm ? inverse_mod_u32(sm, p) : 0;
+		shift[k] = (uint32_t)((uint64_t)window % p * sm % p);
+	}
+
+	BigUInt window_step = step * BigUInt(window);
+	vector<char> composite(window);
+	while (start < limit) {
+		if (stop && stop->load(memory_order_relaxed)) return false;
+		fill(composite.begin(), composite.end(), 0);
+		for (size_t k = 0; k < prime_count; k++) {
+			uint32_t p = primes[k], r = residue[k];
+			if (step_inv[k] == 0) {
+				// 步长被 p 整除：要么全部被筛掉，要么都不受影响
+				if (r == 0) fill(composite.begin(), composite.end(), 1);
+				continue;
+			}
+			for (uint64_t i = (uint64_t)(p - r) % p * step_inv[k] % p; i < window; i += p) composite[i] = 1;
+			residue[k] = (r + shift[k]) % p;
+		}
+		BigUInt candidate = start;
+		for (size_t i = 0; i < window; i++, candidate += step) {
+			if (composite[i]) continue;
+			if (candidate >= limit) return false;
+			if (stop && stop->load(memory_order_relaxed)) return false;
+			if (accept ? (*accept)(candidate) : is_prime(candidate)) {
+				found = candidate;
+				return true;
+			}
+		}
+		start += window_step;
+	}
+	return false;
+}
+
+// 从 q（≡ 5 mod 6）起按 6 递增找 q、2q+1 都是质数的 q，p = 2q+1 越过 limit（不含）仍未找到则返回 false
+bool safe_prime_search(BigUInt q, const BigUInt& limit, BigUInt& found, const atomic<bool>* stop = nullptr) {
+	PROF_SCOPE("safe_prime_search", q.size());
+	// 两条件联合筛选的幸存率低得多，小素数表直接用满（跳过已由 mod 6 处理的 3）
+	uint64_t bound = max<uint64_t>(SIEVE_PRIME_LIMIT, sieve_bound(q.bit_length()));
+	const vector<uint32_t>& primes = sieving_primes(bound);
+	if (q.fits_u64()) bound = min(bound, q.low_u64());
+	size_t prime_count = lower_bound(primes.begin(), primes.end(), bound) - primes.begin();
+	size_t window = SIEVE_WINDOW;
+
+	// q + 6i 被 r 整除：i ≡ -q·6^(-1)；2(q + 6i) + 1 被 r 整除：i ≡ ((r-1)/2 - q)·6^(-1)  (mod r)
+	vector<uint32_t> residue(prime_count), inv6(prime_count);
+	sieving_moduli(bound).residues(q, residue.data(), prime_count);
+	for (size_t k = 1; k < prime_count; k++) {
+		inv6[k] = inverse_mod_u32(6 % primes[k], primes[k]);
+	}
+
+	vector<char> composite(window);
+	while (BigUInt(2) * q + BigUInt(1) < limit) {
+		if (stop && stop->load(memory_order_relaxed)) return false;
+		fill(composite.begin(), composite.end(), 0);
+		for (size_t k = 1; k < prime_count; k++) {
+			uint64_t r = primes[k], res = residue[k];
+			for (uint64_t i = (r - res) % r * inv6[k] % r; i < window; i += r) composite[i] = 1;
+			for (uint64_t i = ((r - 1) / 2 + r - res) % r * inv6[k] % r; i < window; i += r) composite[i] = 1;
+			residue[k] = (uint32_t)((res + 6 * window) % r);
+		}
+		for (size_t i = 0; i < window; i++) {
+			if (composite[i]) continue;
+			BigUInt cq = q + BigUInt(6 * i), p = BigUInt(2) * cq + BigUInt(1);
+			if (p >= limit) return false;
+			if (stop && stop->load(memory_order_relaxed)) return false;
+			if (!fermat_base2(cq) || !fermat_base2(p) || !is_prime(cq)) continue;
+			found = p;
+			return true;
+		}
+		q += BigUInt(6 * window);
+	}
+	return false;
+}
+
+// [lo, hi) 中的随机安全素数（lo >= 10）
+bool random_safe_prime(const BigUInt& lo, const BigUInt& hi, mt19937& gen, BigUInt& prime, const atomic<bool>* stop = nullptr) {
+	// q >= lo/2（向下取整）保证 p = 2q + 1 >= lo
+	BigUInt q_lo = lo / BigUInt(2), q_hi = (hi - BigUInt(1)) / BigUInt(2);
+	while (!(stop && stop->load(memory_order_relaxed))) {
+		BigUInt q = q_lo + random_below(q_hi - q_lo, gen);
+		q += BigUInt((11 - q.mod_small(6)) % 6);
+		if (safe_prime_search(q, hi, prime, stop)) return true;
+	}
+	return false;
+}
+
+// [lo, hi) 中的随机 Gordon 强素数（lo 为 B 位、至少 STRONG_PRIME_MIN_BITS 位，hi - lo 不小于 lo/4；
+// bit_range 给出的 hi 约为 4/3·lo，decimal_range 给出的是 10·lo）：
+// s、t 随机取（各约 B/2-16、B/2-40 位），r 取 2it+1 中的第一个质数，
+// p0 = 2(s^(r-2) mod r)·s - 1 满足 p0 ≡ 1 (mod r)、p0 ≡ -1 (mod s)，p 取 p0 + 2jrs 中的第一个质数。
+// 步长 2rs < 2^(B-30) < lo/2^29，区间里可选的 j 至少有 2^27 个；j 从 j_lo 起、搜索到 hi 为止，p 一定落在 [lo, hi) 内
+bool random_strong_prime(const BigUInt& lo, const BigUInt& hi, mt19937& gen, BigUInt& prime, const atomic<bool>* stop = nullptr) {
+	size_t B = lo.bit_length();
+	BigUInt one(1), two(2);
+	while (!(stop && stop->load(memory_order_relaxed))) {
+		BigUInt s, t, r;
+		if (!random_prime_in(one << (B / 2 - 17), one << (B / 2 - 16), gen, s, stop)) return false;
+		if (!random_prime_in(one << (B / 2 - 41), one << (B / 2 - 40), gen, t, stop)) return false;
+		BigUInt i0 = (one << 23) + random_below(one << 22, gen);
+		if (!progression_search(two * i0 * t + one, two * t, two * (one << 24) * t + one, r, stop)) continue;
+
+		BigUInt p0 = two * power_mod(s, r - two, r) * s - one, step = two * r * s;
+		// j 在使 p 落入 [lo, hi) 的范围里随机起步，留出后半段给向上搜索
+		BigUInt j_lo = lo > p0 ? (lo - p0) / step + one : BigUInt(0), j_hi = (hi - p0) / step;
+		if (j_hi <= j_lo) continue;
+		BigUInt j0 = j_lo + random_below((j_hi - j_lo) / two + one, gen);
+		if (progression_search(p0 + j0 * step, step, hi, prime, stop)) return true;
+	}
+	return false;
+}
+
+// 按种类在 [lo, hi) 中生成一个随机质数
+bool random_prime_of_kind(PrimeKind kind, const BigUInt& lo, const BigUInt& hi, mt19937& gen, BigUInt& prime,
+						  const atomic<bool>* stop = nullptr) {
+	switch (kind) {
+		case PRIME_SAFE: return random_safe_prime(lo, hi, gen, prime, stop);
+		case PRIME_STRONG: return random_strong_prime(lo, hi, gen, prime, stop);
+		default: return random_prime_in(lo, hi, gen, prime, stop);
+	}
+}
+
+// 在所有核心上并行生成 count 个 [lo, hi) 中的指定种类的质数（lo >= 10）
+void generate_primes_in(PrimeKind kind, const BigUInt& lo, const BigUInt& hi, long long count,
+						const function<void(const BigUInt&)>& sink, int threads = 0) {
+	if (kind == PRIME_STRONG && lo.bit_length() < STRONG_PRIME_MIN_BITS) {
+		throw invalid_argument("强素数至少需要 " + to_string(STRONG_PRIME_MIN_BITS) + " 比特（" +
+							   to_string((STRONG_PRIME_MIN_BITS - 1) * 30103 / 100000 + 2) + " 位十进制）");
+	}
+	parallel_generate<BigUInt>(count, [&](mt19937& gen, BigUInt& prime, const atomic<bool>* stop) {
+		return random_prime_of_kind(kind, lo, hi, gen, prime, stop);
+	}, sink, threads);
+}
+
+// 在所有核心上并行生成 count 个 d 位的安全素数或强素数
+void generate_special_primes(PrimeKind kind, int digits, long long count, const function<void(const BigUInt&)>& sink,
+							 int threads = 0) {
+	if (kind == PRIME_SAFE && digits <= 1) {
+		// 一位数的安全素数：5, 7
+		for (long long i = 0; i < count; i++) sink(BigUInt(rng() % 2 ? 5 : 7));
+		return;
+	}
+	BigUInt lo, hi;
+	decimal_range(digits, lo, hi);
+	generate_primes_in(kind, lo, hi, count, sink, threads);
+}
+
+// 按比特数生成：最高两位都是1，bits 不小于 MIN_PRIME_BITS
+const int MIN_PRIME_BITS = 16;
+
+void generate_primes_by_bits(PrimeKind kind, int bits, long long count, const function<void(const BigUInt&)>& sink,
+							 int threads = 0) {
+	if (bits < MIN_PRIME_BITS) throw invalid_argument("比特数至少为 " + to_string(MIN_PRIME_BITS));
+	BigUInt lo, hi;
+	bit_range(bits, lo, hi);
+	generate_primes_in(kind, lo, hi, count, sink, threads);
+}
+
+// ==================== 相邻质数 ====================
+// next_prime / prev_prime / primes_after：从 n 出发按窗口向上（或向下）扫描奇数候选，
+// 用小素数表筛掉有小因子的候选，只对幸存者做素性测试。
+// 窗口 w 交给第 w mod T 个线程：每个线程只在自己的第一个窗口对起点求一次余数，
+// 之后每次跨过 T 个窗口，余数加上（向下时减去）固定的跨度即可。
+// 各线程测完自己的窗口后按窗口顺序轮流交给 sink，所以结果是有序流式输出的；
+// 够数之后其余线程在下一个候选之前退出。
+
+// 从奇数 start（>= 3）起沿 direction（+1 向上，-1 向下，向下到 3 为止）依次输出 count 个质数，返回实际输出的个数
+long long scan_primes(const BigUInt& start, int direction, long long count, const function<void(const BigUInt&)>& sink,
+					  int threads = 0) {
+	if (count <= 0) return 0;
+	PROF_SCOPE("scan_primes", start.size());
+	size_t bits = start.bit_length();
+	uint64_t bound = sieve_bound(bits);
+	const vector<uint32_t>& primes = sieving_primes(bound);
+	const SmallModuli& moduli = sieving_moduli(bound);
+	size_t full_count = lower_bound(primes.begin(), primes.end(), bound) - primes.begin();
+	size_t window = min(SIEVE_WINDOW, max<size_t>(256, 2 * bits));
+	int n = worker_count(threads);
+	const BigUInt three(3);
+	
+	atomic<bool> done(false);
+	atomic<long long> emitted(0);
+	mutex turn_mutex;
+	condition_variable turn;
+	uint64_t next_emit = 0;
+	
+	auto worker = [&](int t) {
+		vector<uint32_t> residue(full_count), shift(full_count);
+		for (size_t k = 0; k < full_count; k++) shift[k] = (uint32_t)(2 * (uint64_t)window * n % primes[k]);
+		vector<char> composite(window);
+		vector<BigUInt> found;
+		bool first = true;
+		for (uint64_t w = t; !done.load(); w += n) {
+			// 窗口的第一个候选与候选个数；向下走到 3 以下就结束
+			BigUInt offset = BigUInt(2 * window) * BigUInt(w), base;
+			size_t len = window;
+			if (direction > 0) {
+				base = start + offset;
+			} else {
+				if (start < offset + three) break;
+				base = start - offset;
+				BigUInt room = (base - three) / BigUInt(2);
+				if (room.fits_u64() && room.low_u64() < window) len = (size_t)room.low_u64() + 1;
+			}
+			if (first) {
+				moduli.residues(base, residue.data(), full_count);
+				first = false;
+			} else {
+				for (size_t k = 0; k < full_count; k++) {
+					uint32_t p = primes[k];
+					residue[k] = direction > 0 ? (residue[k] + shift[k]) % p : (residue[k] + p - shift[k]) % p;
+				}
+			}
+			// 只用小于窗口中最小候选的素数筛，否则候选可能恰好就是筛选素数本身
+			BigUInt lowest = direction > 0 ? base : base - BigUInt(2 * (len - 1));
+			size_t prime_count = lowest.fits_u64()
+				? lower_bound(primes.begin(), primes.begin() + full_count, lowest.low_u64()) - primes.begin()
+				: full_count;
+			fill(composite.begin(), composite.begin() + len, 0);
+			for (size_t k = 0; k < prime_count; k++) {
+				uint32_t p = primes[k], r = residue[k], i;
+				if (direction > 0) {
+					// base + 2i ≡ 0 (mod p) <=> 2i ≡ -r
+					i = r == 0 ? 0 : ((p - r) % 2 == 0 ? (p - r) / 2 : (2 * p - r) / 2);
+				} else {
+					// base - 2i ≡ 0 (mod p) <=> 2i ≡ r
+					i = r % 2 == 0 ? r / 2 : (r + p) / 2;
+				}
+				for (; i < len; i += p) composite[i] = 1;
+			}
+			
+			found.clear();
+			for (size_t i = 0; i < len && !done.load(memory_order_relaxed); i++) {
+				if (composite[i]) continue;
+				// 前面的窗口只会再贡献质数，本窗口已找到的够补足剩余名额就不必再测
+				if ((long long)found.size() >= count - emitted.load()) break;
+				BigUInt candidate = direction > 0 ? base + BigUInt(2 * i) : base - BigUInt(2 * i);
+				if (is_prime(candidate)) found.push_back(candidate);
+			}
+			
+			unique_lock<mutex> lock(turn_mutex);
+			turn.wait(lock, [&] { return next_emit == w || done.load(); });
+			if (done.load()) break;
+			for (const BigUInt& p : found) {
+				if (emitted.load() >= count) break;
+				sink(p);
+				emitted++;
+			}
+			if (emitted.load() >= count) done.store(true);
+			next_emit++;
+			turn.notify_all();
+		}
+	};
+	
+	vector<thread> pool;
+	for (int i = 1; i < n; i++) pool.emplace_back(worker, i);
+	worker(0);
+	for (thread& t : pool) t.join();
+	return emitted.load();
+}
+
+// 大于 n 的前 count 个质数，按从小到大的顺序逐个交给 sink
+void primes_after(const BigUInt& n, long long count, const function<void(const BigUInt&)>& sink, int threads = 0) {
+	if (count <= 0) return;
+	if (n < BigUInt(2)) {
+		sink(BigUInt(2));
+		count--;
+	}
+	BigUInt start = n < BigUInt(3) ? BigUInt(3) : n + BigUInt(n.is_odd() ? 2 : 1);
+	scan_primes(start, 1, count, sink, threads);
+}
+
+vector<BigUInt> primes_after(const BigUInt& n, long long count, int threads = 0) {
+	vector<BigUInt> primes;
+	primes_after(n, count, [&](const BigUInt& p) { primes.push_back(p); }, threads);
+	return primes;
+}
+
+// 大于 n 的最小质数
+BigUInt next_prime(const BigUInt& n, int threads = 0) {
+	return primes_after(n, 1, threads)[0];
+}
+
+// 小于 n 的最大质数（n > 2）
+BigUInt prev_prime(const BigUInt& n, int threads = 0) {
+	if (n <= BigUInt(2)) throw invalid_argument("没有小于 2 的质数");
+	if (n <= BigUInt(3)) return BigUInt(2);
+	BigUInt start = n - BigUInt(n.is_odd() ? 2 : 1), prime(2);
+	scan_primes(start, -1, 1, [&](const BigUInt& p) { prime = p; }, threads);
+	return prime;
+}
+
+// ==================== 可证明质数（Maurer 构造与 Pocklington 证书） ====================
+// 从一个已证明的较小质数 q 递归地构造 p = 2·R·q + 1：q 的比特数至少超过 p 的一半，q^2 > p。
+// Pocklington 定理：若 a^(p-1) ≡ 1 (mod p) 且 gcd(a^((p-1)/q) - 1, p) = 1，则 p 的每个素因子都 ≡ 1 (mod q)，
+// 都大于 q > √p，所以 p 是质数。于是每一级只需一次基 2 费马检查加一次 gcd，代价相当于几次普通的概率测试。
+// 递归到 64 位以内时随机取质数，由确定性米勒-拉宾判定。
+// q 的相对大小按 Maurer 的做法随机取 r = 2^(s-1)（s 在 [0, 1] 均匀）以使结果分布接近均匀。
+//
+// 证书是一条从小到大的链（十进制文本）：
+//   maurer <质数>
+//   <64 位以内的起点质数>
+//   <R> <a>        每一级一行，p = 2·R·q + 1，q 为上一级
+// 校验只需按链重算每一级的两次模幂和 gcd。
+
+// 递归的终点：64 位以内由确定性米勒-拉宾直接判定
+const int MAURER_BASE_BITS = 64;
+// 每一级 p 比 q 至少多这么多比特，保证 R 有足够的取值
+const int MAURER_MIN_STEP_BITS = 20;
+
+struct PrimeCertificate {
+	BigUInt prime;
+	uint64_t base = 0;
+	vector<pair<BigUInt, uint32_t>> steps;   // 每一级的 (R, a)
+	
+	string to_string() const {
+		string s = "maurer " + prime.to_string() + "\n" + std::to_string(base) + "\n";
+		for (const auto& st : steps) s += st.first.to_string() + " " + std::to_string(st.second) + "\n";
+		return s;
+	}
+};
+
+// Pocklington 检查：p = 2·R·q + 1，q 为质数且 q^2 > p
+bool pocklington_step(const BigUInt& p, const BigUInt& q, const BigUInt& R, uint32_t a) {
+	if (q * q <= p) return false;
+	BigUInt base(a), one(1);
+	if (!power_mod(base, p - one, p).is_one()) return false;
+	BigUInt x = power_mod(base, BigUInt(2) * R, p);
+	if (x.is_zero()) return false;
+	return BigUInt::gcd(x - one, p).is_one();
+}
+
+// [lo, hi) 中的可证明质数（hi <= 2^bits，lo >= 2^(bits-1)），证书写入 cert；被 stop 取消时返回 false
+bool maurer_prime(const BigUInt& lo, const BigUInt& hi, mt19937& gen, PrimeCertificate& cert, const atomic<bool>* stop = nullptr) {
+	int bits = (int)(hi - BigUInt(1)).bit_length();
+	if (bits <= MAURER_BASE_BITS) {
+		while (!(stop && stop->load(memory_order_relaxed))) {
+			uint64_t v = (lo + random_below(hi - lo, gen)).low_u64() | 1;
+			if (BigUInt(v) >= hi || !miller_rabin_u64(v)) continue;
+			cert.prime = BigUInt(v);
+			cert.base = v;
+			cert.steps.clear();
+			return true;
+		}
+		return false;
+	}
+	
+	// q 的比特数：r·bits，不少于 bits/2 + 1（q^2 > p），且给 R 留出 MAURER_MIN_STEP_BITS
+	int q_bits;
+	do {
+		double r = pow(2.0, uniform_real_distribution<double>(0, 1)(gen) - 1);
+		q_bits = max((bits + 1) / 2 + 1, (int)(r * bits));
+	} while (q_bits > bits - MAURER_MIN_STEP_BITS);
+	BigUInt one(1), two(2);
+	if (!maurer_prime(one << (q_bits - 1), one << q_bits, gen, cert, stop)) return false;
+	BigUInt q = cert.prime, step = two * q;
+	
+	// R 取 [⌈(lo-1)/2q⌉, ⌈(hi-1)/2q⌉)，使 p = 2Rq + 1 落在 [lo, hi)；
+	// 与 random_prime_in 一样从随机的 R 起沿 p + 2q 做筛选搜索，幸存者只做 Pocklington 检查
+	BigUInt r_lo = (lo - one + step - one) / step, r_hi = (hi - one + step - one) / step, p;
+	function<bool(const BigUInt&)> accept = [&](const BigUInt& c) { return pocklington_step(c, q, (c - one) / step, 2); };
+	while (!(stop && stop->load(memory_order_relaxed))) {
+		BigUInt R = r_lo + random_below(r_hi - r_lo, gen);
+		if (!progression_search(step * R + one, step, hi, p, stop, &accept)) continue;
+		cert.prime = p;
+		cert.steps.emplace_back((p - one) / step, 2);
+		return true;
+	}
+	return false;
+}
+
+// 校验证书，失败时 error 中给出原因
+bool verify_certificate(const PrimeCertificate& cert, string& error) {
+	if (!miller_rabin_u64(cert.base)) {
+		error = "起点 " + to_string(cert.base) + " 不是质数";
+		return false;
+	}
+	BigUInt q(cert.base);
+	for (size_t i = 0; i < cert.steps.size(); i++) {
+		const auto& [R, a] = cert.steps[i];
+		BigUInt p = BigUInt(2) * R * q + BigUInt(1);
+		if (a < 2 || !pocklington_step(p, q, R, a)) {
+			error = "第 " + to_string(i + 1) + " 级 Pocklington 检查失败";
+			return false;
+		}
+		q = p;
+	}
+	if (q != cert.prime) {
+		error = "链的终点与声明的质数不符";
+		return false;
+	}
+	return true;
+}
+
+// 依次读出 in 中的每份证书（空行忽略），交给 visit；格式错误抛出 invalid_argument
+void for_each_certificate(istream& in, const function<void(const PrimeCertificate&)>& visit) {
+	auto decimal = [](const string& s) {
+		if (s.empty() || !all_of(s.begin(), s.end(), ::isdigit)) throw invalid_argument("证书中有非法数字：" + s);
+		return BigUInt(s);
+	};
+	PrimeCertificate cert;
+	bool open = false, has_base = false;
+	auto finish = [&] {
+		if (!open) return;
+		if (!has_base) throw invalid_argument("证书缺少起点");
+		visit(cert);
+	};
+	string line;
+	while (getline(in, line)) {
+		line.erase(remove(line.begin(), line.end(), '\r'), line.end());
+		if (line.empty()) continue;
+		if (line.compare(0, 7, "maurer ") == 0) {
+			finish();
+			cert = PrimeCertificate();
+			cert.prime = decimal(line.substr(7));
+			open = true;
+			has_base = false;
+			continue;
+		}
+		if (!open) throw invalid_argument("证书应以 maurer 开头");
+		if (!has_base) {
+			BigUInt base = decimal(line);
+			if (!base.fits_u64()) throw invalid_argument("证书起点超过 64 位");
+			cert.base = base.low_u64();
+			has_base = true;
+			continue;
+		}
+		// 每一级一行“R a”
+		size_t space = line.find(' ');
+		if (space == string::npos) throw invalid_argument("证书行格式应为“R a”：" + line);
+		BigUInt a = decimal(line.substr(space + 1));
+		if (!a.fits_u64() || a.low_u64() > UINT32_MAX) throw invalid_argument("证书中的底数过大：" + line);
+		cert.steps.emplace_back(decimal(line.substr(0, space)), (uint32_t)a.low_u64());
+	}
+	finish();
+}
+
+// 并行生成 count 个 bits 位（最高两位为1）的可证明质数，每得到一个连同证书交给 sink（串行调用，按完成顺序）
+void generate_provable_primes(int bits, long long count, const function<void(const PrimeCertificate&)>& sink, int threads = 0) {
+	if (bits < MIN_PRIME_BITS) throw invalid_argument("比特数至少为 " + to_string(MIN_PRIME_BITS));
+	if (count <= 0) return;
+	BigUInt lo, hi;
+	bit_range(bits, lo, hi);
+	parallel_generate<PrimeCertificate>(count, [&](mt19937& gen, PrimeCertificate& cert, const atomic<bool>* stop) {
+		return maurer_prime(lo, hi, gen, cert, stop);
+	}, sink, threads);
+}
+
+// ==================== 工作窃取线程池 ====================
+
+// 每个线程一个任务队列：自己从队尾取（刚提交的任务数据还在缓存里），空了就从别的队列队首偷，
+// 耗时不均的任务（例如大数和小数混在一起）不会让某个线程闲着而另一个线程排长队
+class WorkStealingPool {
+private:
+	struct Queue {
+		mutex m;
+		deque<function<void()>> tasks;
+	};
+	vector<unique_ptr<Queue>> queues;
+	vector<thread> workers;
+	mutex wait_mutex;
+	condition_variable wake;
+	size_t available = 0;   // 所有队列中的任务数，受 wait_mutex 保护
+	bool stopping = false;
+	size_t next_queue = 0;
+
+	bool try_pop(size_t self, function<void()>& task) {
+		for (size_t k = 0; k < queues.size(); k++) {
+			Queue& q = *queues[(self + k) % queues.size()];
+			lock_guard<mutex> lock(q.m);
+			if (q.tasks.empty()) continue;
+			if (k == 0) {
+				task = move(q.tasks.back());
+				q.tasks.pop_back();
+			} else {
+				task = move(q.tasks.front());
+				q.tasks.pop_front();
+			}
+			return true;
+		}
+		return false;
+	}
+
+	void worker_loop(size_t self) {
+		while (true) {
+			{
+				unique_lock<mutex> lock(wait_mutex);
+				wake.wait(lock, [&] { return available > 0 || stopping; });
+				if (available == 0) return;
+				--available;
+			}
+			// 已经占到一个任务名额，队列里一定能取到
+			function<void()> task;
+			while (!try_pop(self, task)) {}
+			task();
+		}
+	}
+
+public:
+	explicit WorkStealingPool(int threads) {
+		int n = worker_count(threads);
+		for (int i = 0; i < n; i++) queues.emplace_back(new Queue());
+		for (int i = 0; i < n; i++) workers.emplace_back([this, i] { worker_loop(i); });
+	}
+
+	// 析构时等所有已提交的任务执行完
+	~WorkStealingPool() {
+		{
+			lock_guard<mutex> lock(wait_mutex);
+			stopping = true;
+		}
+		wake.notify_all();
+		for (thread& t : workers) t.join();
+	}
+
+	size_t size() const { return workers.size(); }
+
+	// 轮流放进各线程的队列
+	void submit(function<void()> task) {
+		size_t q;
+		{
+			lock_guard<mutex> lock(wait_mutex);
+			q = next_queue++ % queues.size();
+		}
+		{
+			lock_guard<mutex> lock(queues[q]->m);
+			queues[q]->tasks.push_back(move(task));
+		}
+		{
+			lock_guard<mutex> lock(wait_mutex);
+			++available;
+		}
+		wake.notify_one();
+	}
+};
+
+// 拆分单个测试用的常驻线程池（调用方自己也算一个线程），首次拆分时按 test_threads 建好，之后一直复用
+void submit_split_task(function<void()> task) {
+	static WorkStealingPool pool(max(test_threads - 1, 1));
+	pool.submit(move(task));
+}
+
+// ==================== 批量素性测试 ====================
+
+// 按规模分类统计，类别与实际走的内核一一对应：64位以内由 test_line 直接走原生路径，不构造大整数；
+// 更大的数都交给 is_prime，在 MontContext 内部按 MONT_KARATSUBA_THRESHOLD 分成两种模乘——
+// 以下是乘积与约简合并一遍的乘积扫描，以上是 Karatsuba 乘法加单独约简。
+enum SizeClass { SIZE_NATIVE, SIZE_FIXED, SIZE_GENERAL, SIZE_CLASS_COUNT };
+
+string size_class_name(int cls) {
+	static const string fixed_bits = to_string((hpcore::MONT_KARATSUBA_THRESHOLD - 1) * 64);
+	if (cls == SIZE_NATIVE) return "<=64位";
+	return (cls == SIZE_FIXED ? "<=" : ">") + fixed_bits + "位";
+}
+
+// 占 limbs 个 limb 的数所属的类别
+SizeClass size_class_of(size_t limbs) {
+	if (limbs <= 1) return SIZE_NATIVE;
+	return limbs < hpcore::MONT_KARATSUBA_THRESHOLD ? SIZE_FIXED : SIZE_GENERAL;
+}
+const int LATENCY_BUCKETS = 40;
+
+// 一类输入的统计；延迟按纳秒数的 log2 分桶，用来估计中位数和 p99
+struct ClassStats {
+	long long count = 0, primes = 0;
+	double total_ns = 0, max_ns = 0;
+	long long hist[LATENCY_BUCKETS] = {};
+
+	void add(bool prime, double ns) {
+		count++;
+		primes += prime;
+		total_ns += ns;
+		max_ns = max(max_ns, ns);
+		int b = 0;
+		while (b < LATENCY_BUCKETS - 1 && ns >= (double)(2ULL << b)) b++;
+		hist[b]++;
+	}
+
+	void merge(const ClassStats& o) {
+		count += o.count;
+		primes += o.primes;
+		total_ns += o.total_ns;
+		max_ns = max(max_ns, o.max_ns);
+		for (int b = 0; b < LATENCY_BUCKETS; b++) hist[b] += o.hist[b];
+	}
+
+	// 分位数所在桶的上界（纳秒）
+	double quantile_ns(double q) const {
+		long long target = (long long)(q * count), seen = 0;
+		for (int b = 0; b < LATENCY_BUCKETS; b++) {
+			seen += hist[b];
+			if (seen > target) return min((double)(2ULL << b), max_ns);
+		}
+		return max_ns;
+	}
+};
+
+// 一块连续的输入行：读线程按块提交，工作线程整块处理，输出线程按 seq 排序输出
+struct TestChunk {
+	long long seq = 0, first_index = 0;
+	vector<string> lines;
+	vector<signed char> result;  // 1 质数，0 合数，-1 非法输入
+	ClassStats stats[SIZE_CLASS_COUNT];
+	long long invalid = 0;
+};
+
+// 测试一行输入（十进制数，或 2^p-1、k*2^n±1 形式的表达式），非法输入返回 -1
+signed char test_line(string& line, ClassStats* stats) {
+	line.erase(remove_if(line.begin(), line.end(), ::isspace), line.end());
+	SpecialForm form;
+	bool special = !line.empty() && !all_of(line.begin(), line.end(), ::isdigit);
+	if (line.empty() || (special && !parse_special_form(line, form))) return -1;
+	if (!special) line.erase(0, min(line.find_first_not_of('0'), line.size() - 1));
+	
+	auto t0 = chrono::steady_clock::now();
+	bool prime;
+	SizeClass cls;
+	if (special) {
+		prime = special_form_is_prime(form);
+		// 按数本身占的 limb 数分类，小于 2^64 的（如 2^61-1）归入原生类
+		cls = size_class_of((size_t)((form.bit_length() + 63) / 64));
+	} else if (line.size() <= 19) {
+		// 19位以内一定小于 2^64，直接解析，不构造大整数
+		uint64_t v = 0;
+		for (char c : line) v = v * 10 + (c - '0');
+		prime = miller_rabin_u64(v);
+		cls = SIZE_NATIVE;
+	} else {
+		BigUInt n(line);
+		prime = is_prime(n);
+		cls = size_class_of(n.size());
+	}
+	stats[cls].add(prime, chrono::duration<double, nano>(chrono::steady_clock::now() - t0).count());
+	return prime;
+}
+
+// 从 in 逐行读取十进制数（或特殊形式的表达式），多线程测试后写到 out：
+// 有序模式按输入顺序输出“数 结果”；无序模式谁先算完谁先输出，每行前加输入中的序号（从0开始）。
+// 结果 1 为质数，0 为合数，? 为非法输入。汇总信息输出到 stderr。
+void batch_primality_test(istream& in, ostream& out, bool ordered, int threads) {
+	const size_t CHUNK_LINES = 256;
+	WorkStealingPool pool(threads);
+	// 同时在途的块数有上限，避免输入远快于计算时把整个文件读进内存
+	const long long MAX_IN_FLIGHT = 8 * (long long)pool.size() + 8;
+	
+	mutex out_mutex;
+	condition_variable space;
+	long long in_flight = 0, next_seq = 0, total = 0, invalid = 0;
+	map<long long, unique_ptr<TestChunk>> finished;
+	ClassStats stats[SIZE_CLASS_COUNT];
+	
+	auto write_chunk = [&](const TestChunk& c) {
+		string buf;
+		for (size_t i = 0; i < c.lines.size(); i++) {
+			if (!ordered) buf += to_string(c.first_index + i) + ' ';
+			buf += c.lines[i];
+			buf += c.result[i] < 0 ? " ?\n" : c.result[i] ? " 1\n" : " 0\n";
+		}
+		out << buf;
+		for (int k = 0; k < SIZE_CLASS_COUNT; k++) stats[k].merge(c.stats[k]);
+		invalid += c.invalid;
+		total += c.lines.size();
+		--in_flight;
+	};
+	
+	// 处理完的块：无序模式立即输出；有序模式先暂存，能接上的连续块一起输出
+	auto complete = [&](unique_ptr<TestChunk> c) {
+		lock_guard<mutex> lock(out_mutex);
+		if (!ordered) {
+			write_chunk(*c);
+		} else {
+			finished[c->seq] = move(c);
+			while (!finished.empty() && finished.begin()->first == next_seq) {
+				write_chunk(*finished.begin()->second);
+				finished.erase(finished.begin());
+				next_seq++;
+			}
+		}
+		space.notify_one();
+	};
+	
+	auto start = chrono::steady_clock::now();
+	long long seq = 0, index = 0;
+	string line;
+	bool more = true;
+	while (more) {
+		unique_ptr<TestChunk> chunk(new TestChunk());
+		chunk->seq = seq++;
+		chunk->first_index = index;
+		while (chunk->lines.size() < CHUNK_LINES && (more = (bool)getline(in, line))) {
+			if (line.find_first_not_of(" \t\r") == string::npos) continue;
+			chunk->lines.push_back(line);
+		}
+		if (chunk->lines.empty()) break;
+		index += chunk->lines.size();
+		{
+			unique_lock<mutex> lock(out_mutex);
+			space.wait(lock, [&] { return in_flight < MAX_IN_FLIGHT; });
+			++in_flight;
+		}
+		// std::function 要求可复制，这里用裸指针转交所有权
+		TestChunk* raw = chunk.release();
+		pool.submit([raw, &complete] {
+			unique_ptr<TestChunk> c(raw);
+			c->result.resize(c->lines.size());
+			for (size_t i = 0; i < c->lines.size(); i++) {
+				c->result[i] = test_line(c->lines[i], c->stats);
+				if (c->result[i] < 0) c->invalid++;
+			}
+			complete(move(c));
+		});
+	}
+	{
+		unique_lock<mutex> lock(out_mutex);
+		space.wait(lock, [&] { return in_flight == 0; });
+	}
+	out.flush();
+	
+	double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+	long long primes = 0;
+	for (const ClassStats& st : stats) primes += st.primes;
+	cerr << "共 " << total << " 个数（质数 " << primes << "，非法 " << invalid << "），" << pool.size() << " 个线程，用时 "
+		 << seconds << " 秒，吞吐量 " << (seconds > 0 ? total / seconds : 0.0) << " 个/秒" << endl;
+	for (int k = 0; k < SIZE_CLASS_COUNT; k++) {
+		const ClassStats& st = stats[k];
+		if (st.count == 0) continue;
+		cerr << "  " << size_class_name(k) << "：" << st.count << " 个，质数 " << st.primes
+			 << "，单次延迟（微秒）平均 " << st.total_ns / st.count / 1000 << "，p50 <= " << st.quantile_ns(0.5) / 1000
+			 << "，p99 <= " << st.quantile_ns(0.99) / 1000 << "，最大 " << st.max_ns / 1000 << endl;
+	}
+}
+
+// ==================== 区间分段筛（mod 30 轮） ====================
+// 每个字节表示 30 个连续整数中与 30 互素的 8 个（余数 1,7,11,13,17,19,23,29），一位一个数，置位表示合数。
+// 2、3、5 的倍数根本不存储，内存和标记次数都只有普通筛的 8/30。
+// 素数 p 的倍数 p·m 中，m 模 30 余数相同的那些构成步长 30p 的等差数列，在位图里是步长 p 字节、位置固定的一列，
+// 所以每个筛选素数拆成 8 条数列各自标记。
+// 段大小等于 L1 数据缓存；步长超过一个段的大素数每段至多命中一次，放进按段编号的桶里，
+// 只在命中的那个段被处理，不必每段都遍历全部大素数。
+
+const uint32_t wheel_residues[8] = {1, 7, 11, 13, 17, 19, 23, 29};
+// wheel_mask[r]：余数 r 对应的位，与 30 不互素时为 0
+const uint8_t wheel_mask[30] = {
+	0, 1, 0, 0, 0, 0, 0, 2, 0, 0, 0, 4, 0, 8, 0, 0, 0, 16, 0, 32, 0, 0, 0, 64, 0, 0, 0, 0, 0, 128
+};
+const size_t SEGMENT_BYTES = 32 * 1024;
+// 筛选素数要筛到 sqrt(b)，10^16 时为 10^8，再大筛选素数表本身就放不下了
+const uint64_t RANGE_SIEVE_MAX = 10000000000000000ULL;
+
+// [7, n] 中的素数（预计算素数表覆盖 n 时直接从位图取，否则用只存奇数的埃氏筛）
+vector<uint32_t> wheel_sieving_primes(uint32_t n) {
+	vector<uint32_t> primes;
+	if (n < 7) return primes;
+	const PrimeTable* table = hpcore::default_prime_table();
+	if (table && n < table->limit()) {
+		table->for_each_prime(7, (uint64_t)n + 1, [&](uint64_t p) { primes.push_back((uint32_t)p); });
+		return primes;
+	}
+	vector<bool> composite(n / 2 + 1, false);
+	for (uint64_t i = 3; i * i <= n; i += 2) {
+		if (composite[i / 2]) continue;
+		for (uint64_t j = i * i; j <= n; j += 2 * i) composite[j / 2] = true;
+	}
+	for (uint64_t i = 7; i <= n; i += 2) {
+		if (!composite[i / 2]) primes.push_back((uint32_t)i);
+	}
+	return primes;
+}
+
+// 大素数桶中的一项：下一次命中的字节偏移（相对块起点）、步长、位掩码
+struct SieveBucketEntry {
+	uint32_t offset;
+	uint32_t stride;
+	uint8_t mask;
+};
+
+// 筛一块 [base, base + 30*nbytes)（base 为 30 的倍数），每筛完一段调用 emit(段起点, 段位图, 字节数)
+// primes 为 [7, sqrt(块上界)] 中的筛选素数
+template <class F>
+void sieve_block(uint64_t base, size_t nbytes, const vector<uint32_t>& primes, F emit) {
+	PROF_SCOPE("sieve_block", nbytes / 8);
+	uint64_t hi = base + 30 * (uint64_t)nbytes;
+	size_t segments = (nbytes + SEGMENT_BYTES - 1) / SEGMENT_BYTES;
+	// 步长不超过一个段的素数：每条数列记录下一次命中的偏移
+	vector<uint32_t> small_next, small_stride;
+	vector<uint8_t> small_mask;
+	vector<vector<SieveBucketEntry>> buckets(segments);
+	for (uint32_t p : primes) {
+		if ((uint64_t)p * p >= hi) break;
+		// 从 p^2 或块起点开始；连续 30 个乘数中与 30 互素的 8 个各起一条数列
+		uint64_t q = max<uint64_t>(p, (base + p - 1) / p);
+		for (uint64_t m = q; m < q + 30; m++) {
+			if (!wheel_mask[m % 30]) continue;
+			uint64_t v = (uint64_t)p * m;
+			if (v >= hi) continue;
+			uint32_t offset = (uint32_t)((v - base) / 30);
+			uint8_t mask = wheel_mask[v % 30];
+			if (p <= SEGMENT_BYTES) {
+				small_next.push_back(offset);
+				small_stride.push_back(p);
+				small_mask.push_back(mask);
+			} else {
+				buckets[offset / SEGMENT_BYTES].push_back({offset, p, mask});
+			}
+		}
+	}
+	
+	vector<uint8_t> seg(SEGMENT_BYTES);
+	for (size_t s = 0; s < segments; s++) {
+		uint32_t lo = (uint32_t)(s * SEGMENT_BYTES);
+		uint32_t len = (uint32_t)min(SEGMENT_BYTES, nbytes - lo);
+		uint32_t end = lo + len;
+		uint8_t* sp = seg.data() - lo;
+		fill(seg.begin(), seg.begin() + len, 0);
+		for (size_t k = 0; k < small_next.size(); k++) {
+			uint32_t off = small_next[k], stride = small_stride[k];
+			uint8_t mask = small_mask[k];
+			for (; off < end; off += stride) sp[off] |= mask;
+			small_next[k] = off;
+		}
+		for (const SieveBucketEntry& e : buckets[s]) {
+			sp[e.offset] |= e.mask;
+			uint64_t next = (uint64_t)e.offset + e.stride;
+			if (next < nbytes) buckets[next / SEGMENT_BYTES].push_back({(uint32_t)next, e.stride, e.mask});
+		}
+		vector<SieveBucketEntry>().swap(buckets[s]);
+		// 1 不是质数
+		if (base + 30 * (uint64_t)lo == 0) seg[0] |= 1;
+		emit(base + 30 * (uint64_t)lo, seg.data(), len);
+	}
+}
+
+// 多线程筛 [a, b]：out 非空时按从小到大把质数逐行写出，否则只计数；返回质数个数
+// 区间按块分给各线程（每块若干段，各线程独立初始化自己的数列和桶），
+// 写出时每个线程等到轮到自己的块再写，内存只占每线程一块的输出缓冲
+uint64_t sieve_range(uint64_t a, uint64_t b, ostream* out, int threads = 0) {
+	if (b > RANGE_SIEVE_MAX) throw invalid_argument("区间上界不能超过 10^16");
+	if (a > b) return 0;
+	
+	uint64_t count = 0;
+	string head;
+	for (uint64_t p : {2, 3, 5}) {
+		if (p >= a && p <= b) {
+			count++;
+			head += to_string(p) + '\n';
+		}
+	}
+	if (out) *out << head;
+	
+	uint32_t root = (uint32_t)sqrtl((long double)b);
+	while ((uint64_t)root * root > b) root--;
+	while ((uint64_t)(root + 1) * (root + 1) <= b) root++;
+	vector<uint32_t> primes = wheel_sieving_primes(root);
+	
+	uint64_t first_byte = a / 30, last_byte = b / 30;
+	// 只计数时块大一些，摊薄每块初始化数列的开销；写出时块小一些，限制输出缓冲
+	uint64_t block_bytes = (out ? 16 : 128) * SEGMENT_BYTES;
+	uint64_t blocks = (last_byte - first_byte) / block_bytes + 1;
+	
+	atomic<uint64_t> next_block(0), total(count);
+	mutex write_mutex;
+	condition_variable turn;
+	uint64_t next_write = 0;
+	auto worker = [&] {
+		string buf;
+		char digits[24];
+		for (uint64_t blk; (blk = next_block.fetch_add(1)) < blocks;) {
+			uint64_t begin = first_byte + blk * block_bytes;
+			uint64_t nbytes = min(block_bytes, last_byte + 1 - begin);
+			uint64_t local = 0;
+			buf.clear();
+			sieve_block(begin * 30, (size_t)nbytes, primes, [&](uint64_t seg_base, const uint8_t* bits, uint32_t len) {
+				bool inside = seg_base >= a && seg_base + 30 * (uint64_t)len - 1 <= b;
+				if (inside && !out) {
+					// 整段都在区间内：直接数 0 位
+					uint32_t i = 0;
+					for (; i + 8 <= len; i += 8) {
+						uint64_t w;
+						memcpy(&w, bits + i, 8);
+						local += __builtin_popcountll(~w);
+					}
+					for (; i < len; i++) local += __builtin_popcount((uint8_t)~bits[i]);
+					return;
+				}
+				for (uint32_t i = 0; i < len; i++) {
+					for (uint8_t free_bits = (uint8_t)~bits[i]; free_bits; free_bits &= free_bits - 1) {
+						uint64_t v = seg_base + 30 * (uint64_t)i + wheel_residues[__builtin_ctz(free_bits)];
+						if (v < a || v > b) continue;
+						local++;
+						if (out) {
+							char* e = to_chars(digits, digits + sizeof(digits), v).ptr;
+							*e++ = '\n';
+							buf.append(digits, e);
+						}
+					}
+				}
+			});
+			total.fetch_add(local);
+			if (out) {
+				unique_lock<mutex> lock(write_mutex);
+				turn.wait(lock, [&] { return next_write == blk; });
+				out->write(buf.data(), buf.size());
+				next_write++;
+				turn.notify_all();
+			}
+		}
+	};
+	
+	int n = (int)min<uint64_t>(worker_count(threads), blocks);
+	vector<thread> pool;
+	for (int i = 1; i < n; i++) pool.emplace_back(worker);
+	worker();
+	for (thread& t : pool) t.join();
+	if (out) out->flush();
+	return total.load();
+}
+
+// ==================== 素数计数 π(x)（LMO 组合算法） ====================
+// Lagarias-Miller-Odlyzko：取 y = α·x^(1/3)，a = π(y)，
+//   π(x) = φ(x, a) + a - 1 - P2(x, a)
+// 其中 φ(x, a) 是 [1, x] 中不被前 a 个素数整除的数的个数，P2(x, a) = Σ_{y < p <= √x} (π(x/p) - π(p) + 1)。
+// φ(x, a) 按 φ(x, b) = φ(x, b-1) - φ(x/p_b, b-1) 展开成叶子：
+//   普通叶子 S1 = Σ_{n <= y, lpf(n) > p_c} μ(n)·φ(x/n, c)，φ(·, c) 对前 c 个素数按周期查表；
+//   特殊叶子 S2 = -Σ_{b > c} Σ_{y/p_b < m <= y, lpf(m) > p_b} μ(m)·φ(x/(p_b·m), b-1)，
+//   x/(p_b·m) 都小于 z = x/y，在 [1, z) 上按段筛选，边筛掉 p_b 边用树状数组回答段内的 φ 查询。
+// P2 同样只需要 [0, z) 上一遍分段计数筛。两个筛选阶段都在 z 以内，时间约 O(x^(2/3))，
+// 除筛选段外只需 μ、lpf 和素数表这些 O(y) 的数组。
+// 两个阶段都把区间切成块分给多个线程：块内只算“相对块起点”的部分，
+// 块起点之前的计数（P2 的 π(块起点)、S2 的 φ(块起点, b-1)）在全部块完成后按顺序前缀合并。
+
+// 更小的 x 直接用区间筛计数
+const uint64_t PI_SIEVE_THRESHOLD = 10000000;
+// y = α·x^(1/3) 时 μ、lpf 表和筛选段都还很小，上限只受运行时间约束
+const uint64_t PI_MAX = 1000000000000000000ULL;
+// φ(x, c) 查表用的小素数个数：2·3·5·7·11·13 = 30030
+const int PI_TINY_PRIMES = 6;
+
+// ⌊x^(1/k)⌋（k = 2, 3）
+uint64_t integer_root_u64(uint64_t x, int k) {
+	uint64_t r = (uint64_t)powl((long double)x, 1.0L / k);
+	auto power = [k](uint64_t v) { return k == 2 ? (unsigned __int128)v * v : (unsigned __int128)v * v * v; };
+	while (r > 0 && power(r) > x) r--;
+	while (power(r + 1) <= x) r++;
+	return r;
+}
+
+// 前 c 个素数的 φ(x, c)：与它们都互素的数按素数阶乘周期重复
+struct PhiTiny {
+	uint64_t period = 1;
+	vector<uint32_t> table;   // table[i]：[1, i] 中与前 c 个素数都互素的个数
+	
+	PhiTiny(const vector<uint32_t>& primes, int c) {
+		for (int i = 0; i < c; i++) period *= primes[i];
+		table.assign(period, 0);
+		uint32_t count = 0;
+		for (uint64_t v = 1; v < period; v++) {
+			bool coprime = true;
+			for (int i = 0; i < c && coprime; i++) coprime = v % primes[i] != 0;
+			count += coprime;
+			table[v] = count;
+		}
+	}
+	
+	uint64_t operator()(uint64_t x) const {
+		// 一个周期 [1, period] 中互素的个数就是 table[period-1]（period 本身不互素）
+		return x / period * table[period - 1] + table[x % period];
+	}
+};
+
+// [lo, hi] 中的全部素数；primes 为 [7, sqrt(hi)] 中的筛选素数
+vector<uint64_t> primes_between(uint64_t lo, uint64_t hi, const vector<uint32_t>& primes) {
+	vector<uint64_t> result;
+	for (uint64_t p : {2, 3, 5}) {
+		if (p >= lo && p <= hi) result.push_back(p);
+	}
+	if (lo > hi) return result;
+	uint64_t first = lo / 30, nbytes = hi / 30 - first + 1;
+	sieve_block(first * 30, (size_t)nbytes, primes, [&](uint64_t seg_base, const uint8_t* bits, uint32_t len) {
+		for (uint32_t i = 0; i < len; i++) {
+			for (uint8_t free_bits = (uint8_t)~bits[i]; free_bits; free_bits &= free_bits - 1) {
+				uint64_t v = seg_base + 30 * (uint64_t)i + wheel_residues[__builtin_ctz(free_bits)];
+				if (v >= lo && v <= hi) result.push_back(v);
+			}
+		}
+	});
+	return result;
+}
+
+// 按块并行执行 task(块号)，块号从小到大领取
+template <class F>
+void parallel_blocks(uint64_t blocks, int threads, F task) {
+	atomic<uint64_t> next_block(0);
+	auto worker = [&] {
+		for (uint64_t blk; (blk = next_block.fetch_add(1)) < blocks;) task(blk);
+	};
+	int n = (int)min<uint64_t>(worker_count(threads), blocks);
+	vector<thread> pool;
+	for (int i = 1; i < n; i++) pool.emplace_back(worker);
+	worker();
+	for (thread& t : pool) t.join();
+}
+
+// P2(x, a)：y < p <= √x 的每个素数贡献 π(x/p) - π(p) + 1。
+// x/p 落在 [√x, z) 中，把 [0, z) 切块计数筛：每块记下块内素数个数、落在块内的 x/p 个数，
+// 以及这些 x/p 各自到块起点之间的素数个数之和，最后按块顺序加上块起点之前的素数个数
+unsigned __int128 lmo_p2(uint64_t x, uint64_t y, uint64_t z, uint64_t a, int threads) {
+	uint64_t root = integer_root_u64(x, 2);
+	if (root <= y) return 0;
+	vector<uint32_t> sieving = wheel_sieving_primes((uint32_t)integer_root_u64(z, 2) + 1);
+	vector<uint32_t> small = wheel_sieving_primes((uint32_t)integer_root_u64(root, 2) + 1);
+	
+	struct P2Block { uint64_t primes = 0, hits = 0, partial = 0; };
+	uint64_t block_bytes = 128 * SEGMENT_BYTES, last_byte = z / 30;
+	uint64_t blocks = last_byte / block_bytes + 1;
+	vector<P2Block> result(blocks);
+	
+	parallel_blocks(blocks, threads, [&](uint64_t blk) {
+		uint64_t first = blk * block_bytes, nbytes = min(block_bytes, last_byte + 1 - first);
+		uint64_t lo = first * 30, hi = (first + nbytes) * 30;   // 块覆盖 [lo, hi)
+		// x/p ∈ [lo, hi) ⇔ x/hi < p <= x/lo；x/p 从小到大即 p 从大到小
+		vector<uint64_t> ps;
+		uint64_t p_lo = max(y, x / hi) + 1, p_hi = lo ? min(root, x / lo) : root;
+		if (p_lo <= p_hi) ps = primes_between(p_lo, p_hi, small);
+		P2Block& r = result[blk];
+		r.hits = ps.size();
+		uint64_t count = 0;
+		sieve_block(lo, (size_t)nbytes, sieving, [&](uint64_t seg_base, const uint8_t* bits, uint32_t len) {
+			uint32_t i = 0;
+			// 目标 t = x/p 所在字节之前整字节计数，字节内只数余数不超过 t 的位
+			while (!ps.empty()) {
+				uint64_t t = x / ps.back();
+				if (t >= seg_base + 30 * (uint64_t)len) break;
+				uint32_t target = (uint32_t)((t - seg_base) / 30);
+				for (; i < target; i++) count += __builtin_popcount((uint8_t)~bits[i]);
+				uint32_t rem = (uint32_t)((t - seg_base) % 30);
+				uint8_t upto = 0;
+				for (int j = 0; j < 8 && wheel_residues[j] <= rem; j++) upto |= 1 << j;
+				r.partial += count + __builtin_popcount((uint8_t)(~bits[i] & upto));
+				ps.pop_back();
+			}
+			for (; i + 8 <= len; i += 8) {
+				uint64_t w;
+				memcpy(&w, bits + i, 8);
+				count += __builtin_popcountll(~w);
+			}
+			for (; i < len; i++) count += __builtin_popcount((uint8_t)~bits[i]);
+		});
+		r.primes = count;
+	});
+	
+	// π(t) = 3（2、3、5）+ 位图中不超过 t 的素数个数
+	unsigned __int128 sum = 0;
+	uint64_t before = 3, b = a;
+	for (const P2Block& r : result) {
+		sum += (unsigned __int128)r.hits * before + r.partial;
+		before += r.primes;
+		b += r.hits;
+	}
+	// 减去 Σ_{k=a+1}^{b} (k - 1)
+	return sum - ((unsigned __int128)b * (b - 1) - (unsigned __int128)a * (a - 1)) / 2;
+}
+
+// S2 段内的筛：段起点为奇数，只存奇数，一位一个数（置位表示尚未筛掉），另按每 512 位记一个计数。
+// 同一个 b 的查询位置 x/(p_b·m) 随 m 递减而递增，所以查询从段首连续向后扫：先整块加计数，再逐字 popcount
+struct LeafSieve {
+	static const size_t BLOCK_WORDS = 8;
+	vector<uint64_t> words;
+	vector<int32_t> counts;
+	
+	// 扫描位置：words[0, word) 已计入 count
+	struct Scan {
+		size_t word = 0;
+		int64_t count = 0;
+	};
+	
+	void reset(size_t bits) {
+		words.assign((bits + 63) / 64, ~0ULL);
+		if (bits % 64) words.back() = (1ULL << (bits % 64)) - 1;
+		counts.assign((words.size() + BLOCK_WORDS - 1) / BLOCK_WORDS, 0);
+	}
+	// 直接清位后重建计数（用于段初始的小素数）
+	void clear_fast(size_t i) { words[i >> 6] &= ~(1ULL << (i & 63)); }
+	int64_t recount() {
+		int64_t total = 0;
+		fill(counts.begin(), counts.end(), 0);
+		for (size_t w = 0; w < words.size(); w++) counts[w / BLOCK_WORDS] += __builtin_popcountll(words[w]);
+		for (int32_t k : counts) total += k;
+		return total;
+	}
+	// 筛掉第 i 位，原本未筛掉时返回 true
+	bool remove(size_t i) {
+		uint64_t bit = 1ULL << (i & 63);
+		if (!(words[i >> 6] & bit)) return false;
+		words[i >> 6] ^= bit;
+		counts[(i >> 6) / BLOCK_WORDS]--;
+		return true;
+	}
+	// [0, i] 中尚未筛掉的个数，i 不小于同一 scan 上一次查询的位置
+	int64_t count_upto(Scan& s, size_t i) const {
+		size_t w = i >> 6;
+		for (; s.word < w && s.word % BLOCK_WORDS; s.word++) s.count += __builtin_popcountll(words[s.word]);
+		for (; s.word + BLOCK_WORDS <= w; s.word += BLOCK_WORDS) s.count += counts[s.word / BLOCK_WORDS];
+		for (; s.word < w; s.word++) s.count += __builtin_popcountll(words[s.word]);
+		return s.count + __builtin_popcountll(words[w] & (~0ULL >> (63 - (i & 63))));
+	}
+};
+
+// S2：[1, z) 按段筛，段内依次处理 b = c+1, c+2, ...（primes 下标 b-1）：
+// 先回答 φ(x/(p_b·m), b-1) 查询（段内部分由段内计数给出），记下当前段剩余个数，再筛掉 p_b 的倍数。
+// 块起点之前的部分 φ(块起点 - 1, b-1) 对同一 b 的查询都相同，块内只按 b 累加 Σ -μ(m)，
+// 合并时乘上前面各块的剩余个数之和
+__int128 lmo_s2(uint64_t x, uint64_t y, uint64_t z, int c, const vector<uint32_t>& primes,
+				const vector<int8_t>& mu, const vector<uint32_t>& lpf, int threads) {
+	size_t a = primes.size();
+	// 段长取 2 的幂且不小于 √z（只存奇数，位图占 段长/16 字节）
+	uint64_t seg_size = 1 << 16;
+	while (seg_size * seg_size < z) seg_size <<= 1;
+	uint64_t segments = (z - 1 + seg_size - 1) / seg_size;
+	// 每块若干段；越靠后的段能产生叶子的 b 越少，块内记录只到本块用到的最大 b
+	uint64_t blocks = min<uint64_t>(segments, (uint64_t)worker_count(threads) * 8);
+	
+	struct S2Block {
+		__int128 local = 0;
+		vector<int64_t> remaining;   // remaining[b]：本块已处理的段筛掉前 b 个素数后剩余的个数
+		vector<int64_t> mu_sum;      // mu_sum[b]：本块中 φ(·, b) 查询的 -μ(m) 之和
+	};
+	vector<S2Block> result(blocks);
+	
+	parallel_blocks(blocks, threads, [&](uint64_t blk) {
+		S2Block& r = result[blk];
+		LeafSieve sieve;
+		uint64_t seg_begin = segments * blk / blocks, seg_end = segments * (blk + 1) / blocks;
+		for (uint64_t s = seg_begin; s < seg_end; s++) {
+			// 段 [low, high)，low 为奇数，第 i 位表示 low + 2i
+			uint64_t low = 1 + s * seg_size, high = min(low + seg_size, z);
+			sieve.reset((size_t)((high - low + 1) / 2));
+			// p 的奇数倍从 p·k（k 为 >= low/p 的最小奇数）开始，位间隔恰为 p
+			auto first_multiple = [&](uint64_t p) {
+				uint64_t k = (low + p - 1) / p;
+				return (k | 1) * p;
+			};
+			for (int i = 1; i < c; i++) {
+				uint64_t p = primes[i];
+				for (uint64_t v = first_multiple(p); v < high; v += 2 * p) sieve.clear_fast((size_t)((v - low) / 2));
+			}
+			int64_t left = sieve.recount();
+			uint64_t limit = x / low;
+			for (size_t b = c; b < a; b++) {
+				uint64_t p = primes[b];
+				// m > p，x/(p·m) < x/p^2 < low 时后面的素数都不会再有叶子落进本段
+				if (p * p > limit) break;
+				if (r.remaining.size() <= b) {
+					r.remaining.resize(b + 1, 0);
+					r.mu_sum.resize(b + 1, 0);
+				}
+				int64_t before = r.remaining[b];
+				LeafSieve::Scan scan;
+				auto phi = [&](uint64_t m) { return before + sieve.count_upto(scan, (size_t)((x / (p * m) - low) / 2)); };
+				uint64_t min_m = max(x / (p * high), y / p), max_m = min(x / (p * low), y);
+				if (p * p > y) {
+					// lpf(m) > p > √y 且 m <= y 的只有素数 m，μ(m) = -1，直接在素数表里取区间（从大到小）
+					auto first = upper_bound(primes.begin(), primes.end(), max(min_m, p));
+					auto last = upper_bound(first, primes.end(), max_m);
+					for (auto q = last; q != first;) r.local += phi(*--q);
+					r.mu_sum[b] += last - first;
+				} else {
+					for (uint64_t m = max_m; m > min_m; m--) {
+						if (mu[m] == 0 || lpf[m] <= p) continue;
+						r.local -= mu[m] * phi(m);
+						r.mu_sum[b] -= mu[m];
+					}
+				}
+				r.remaining[b] += left;
+				for (uint64_t v = first_multiple(p); v < high; v += 2 * p) left -= sieve.remove((size_t)((v - low) / 2));
+			}
+		}
+	});
+	
+	__int128 sum = 0;
+	vector<int64_t> before(a, 0);   // before[b]：前面各块筛掉前 b 个素数后剩余个数之和，即 φ(块起点 - 1, b)
+	for (const S2Block& r : result) {
+		sum += r.local;
+		for (size_t b = 0; b < r.mu_sum.size(); b++) {
+			sum += (__int128)r.mu_sum[b] * before[b];
+			before[b] += r.remaining[b];
+		}
+	}
+	return sum;
+}
+
+// π(x)：x <= PI_MAX
+uint64_t prime_pi(uint64_t x, int threads = 0) {
+	if (x > PI_MAX) throw invalid_argument("x 不能超过 10^18");
+	if (x < PI_SIEVE_THRESHOLD) return x < 2 ? 0 : sieve_range(2, x, nullptr, threads);
+	
+	// α 随 x 缓慢增大：y 越大 z = x/y 越小，筛选更快，但特殊叶子更多（实测 10^12~10^14 时 3~4 最快）
+	double alpha = max(1.0, log((double)x) / 8);
+	uint64_t x13 = integer_root_u64(x, 3);
+	uint64_t y = min<uint64_t>((uint64_t)(alpha * x13), integer_root_u64(x, 2));
+	y = max(y, x13);
+	uint64_t z = x / y;
+	
+	// y 以内的素数、最小素因子和 Möbius 函数（lpf[1] 视为无穷大）
+	vector<uint32_t> lpf(y + 1, 0);
+	vector<int8_t> mu(y + 1, 1);
+	vector<uint32_t> primes;
+	for (uint64_t i = 2; i <= y; i++) {
+		if (lpf[i]) continue;
+		primes.push_back((uint32_t)i);
+		for (uint64_t j = i; j <= y; j += i) {
+			if (!lpf[j]) lpf[j] = (uint32_t)i;
+			mu[j] = -mu[j];
+		}
+		for (uint64_t j = i * i; j <= y; j += i * i) mu[j] = 0;
+	}
+	lpf[1] = UINT32_MAX;
+	uint64_t a = primes.size();
+	int c = (int)min<uint64_t>(PI_TINY_PRIMES, a);
+	
+	PhiTiny phi_tiny(primes, c);
+	__int128 s1 = 0;
+	for (uint64_t n = 1; n <= y; n++) {
+		if (mu[n] != 0 && lpf[n] > primes[c - 1]) s1 += mu[n] * (__int128)phi_tiny(x / n);
+	}
+	__int128 s2 = lmo_s2(x, y, z, c, primes, mu, lpf, threads);
+	unsigned __int128 p2 = lmo_p2(x, y, z, a, threads);
+	return (uint64_t)(s1 + s2 + (__int128)a - 1 - (__int128)p2);
+}
+
+// ==================== 预计算素数表 ====================
+// 生成 primetable.h 描述的 .hppt 文件：mod 30 位图（与区间筛同一布局，取反后置位表示质数）
+// 加上深筛用的 2^21 以下奇素数及其多模数分组。把文件放在当前目录下（或用 HP_PRIME_TABLE 指定路径），
+// 各模式启动时就直接映射它，不必再筛小素数表、求分组逆元，2^32 以内的数也改为查表。
+
+const uint64_t PRIME_TABLE_DEFAULT_LIMIT = 1ULL << 32;
+// 2^40 的位图约 34 GiB，再大已不值得存表
+const uint64_t PRIME_TABLE_MAX = 1ULL << 40;
+
+// 生成覆盖 [0, limit) 的素数表写入 path（limit 向上取到 30 的倍数），返回其中的质数个数
+// 按轮把若干块分给各线程筛，每轮结束后按顺序写出，内存只占每线程一块
+uint64_t make_prime_table(const string& path, uint64_t limit, int threads = 0) {
+	if (limit == 0 || limit > PRIME_TABLE_MAX) throw invalid_argument("素数表上界须在 1 到 2^40 之间");
+	limit = (limit + 29) / 30 * 30;
+	// 先备好小素数再打开输出：覆盖正在使用的旧表时，之后不会再读到被截断的映射
+	SmallModuli moduli(deep_sieve_primes());
+	vector<uint32_t> primes = wheel_sieving_primes((uint32_t)integer_root_u64(limit, 2) + 1);
+	ofstream out(path, ios::binary);
+	if (!out) throw runtime_error("无法写入文件：" + path);
+	hpcore::PrimeTableWriter writer(out, limit, DEEP_SIEVE_PRIME_LIMIT, moduli);
+	
+	uint64_t total_bytes = limit / 30, block_bytes = 128 * SEGMENT_BYTES;
+	uint64_t blocks = (total_bytes + block_bytes - 1) / block_bytes;
+	uint64_t round = (uint64_t)worker_count(threads);
+	uint64_t count = 3;   // 2、3、5
+	vector<vector<uint8_t>> buffers(round);
+	vector<uint64_t> counts(round);
+	for (uint64_t first = 0; first < blocks; first += round) {
+		uint64_t n = min(round, blocks - first);
+		parallel_blocks(n, threads, [&](uint64_t i) {
+			uint64_t begin = (first + i) * block_bytes;
+			vector<uint8_t>& buf = buffers[i];
+			buf.resize((size_t)min(block_bytes, total_bytes - begin));
+			uint64_t local = 0;
+			sieve_block(begin * 30, buf.size(), primes, [&](uint64_t seg_base, const uint8_t* bits, uint32_t len) {
+				uint8_t* dst = buf.data() + (seg_base / 30 - begin);
+				for (uint32_t k = 0; k < len; k++) {
+					dst[k] = (uint8_t)~bits[k];
+					local += __builtin_popcount(dst[k]);
+				}
+			});
+			counts[i] = local;
+		});
+		for (uint64_t i = 0; i < n; i++) {
+			writer.write_bitmap(buffers[i].data(), buffers[i].size());
+			count += counts[i];
+		}
+	}
+	writer.finish(count);
+	return count;
+}
+
+// ==================== 质数 k 元组（质数星座） ====================
+// 找 n, n+o_1, ..., n+o_{k-1} 全是质数的 n：孪生 {0,2}、表兄弟 {0,4}、四元组 {0,2,6,8} 等。
+// 逐个成员分别搜索要对每个位置做 k 遍测试，这里一次筛掉所有成员：
+// n 只取模 210 的可容许余数（n+o 全都与 2·3·5·7 互素），每个余数 r 一行，行内第 j 个位置是 n = base + r + 210j。
+// 对筛选素数 p 和偏移 o，n+o ≡ 0 (mod p) 的位置是 j ≡ -(base+o)·210^(-1) - r·210^(-1) (mod p)，
+// 前一项每个窗口对每个 (p, o) 求一次，后一项与窗口无关、按 (行, p) 预先算好，各行的起点只差一次减法。
+// 任一成员有小因子该位置就被划掉，只对全部成员都幸存的位置做素性测试（大数先对所有成员做基2费马检查）；
+// 区间上界加跨度不超过筛选上界的平方时，幸存者已经全是质数，不必再测。
+// 窗口的分配与按序输出同 scan_primes：窗口 w 交给第 w mod T 个线程，余数逐窗口递推，测完按窗口顺序交给 sink。
+
+const uint32_t CONSTELLATION_WHEEL = 210;
+// 偏移的上限：跨度再大就谈不上“星座”了
+const uint32_t CONSTELLATION_MAX_SPAN = 1000000;
+
+struct Constellation {
+	vector<uint32_t> offsets;    // 从 0 开始严格递增
+	vector<uint32_t> residues;   // n mod 210 可取的余数，从小到大
+};
+
+// 由样式建星座：常用名称或逗号分隔的偏移（如 0,2,6,8）。
+// 不可容许的样式（偏移占满了某个素数 p 的全部余数，于是除了含 p 本身的极少数情形外不可能全是质数）抛出 invalid_argument
+Constellation make_constellation(const string& spec) {
+	static const map<string, vector<uint32_t>> named = {
+		{"twin", {0, 2}}, {"cousin", {0, 4}}, {"sexy", {0, 6}},
+		{"triplet", {0, 2, 6}}, {"triplet2", {0, 4, 6}}, {"quadruplet", {0, 2, 6, 8}},
+		{"quintuplet", {0, 2, 6, 8, 12}}, {"quintuplet2", {0, 4, 6, 10, 12}}, {"sextuplet", {0, 4, 6, 10, 12, 16}},
+	};
+	Constellation c;
+	auto it = named.find(spec);
+	if (it != named.end()) {
+		c.offsets = it->second;
+	} else {
+		for (size_t pos = 0; pos < spec.size();) {
+			size_t comma = min(spec.find(',', pos), spec.size());
+			c.offsets.push_back((uint32_t)stoul(spec.substr(pos, comma - pos)));
+			pos = comma + 1;
+		}
+	}
+	if (c.offsets.empty() || c.offsets[0] != 0 || c.offsets.back() > CONSTELLATION_MAX_SPAN ||
+		adjacent_find(c.offsets.begin(), c.offsets.end(), greater_equal<uint32_t>()) != c.offsets.end()) {
+		throw invalid_argument("样式的偏移须从 0 开始严格递增，且不超过 " + to_string(CONSTELLATION_MAX_SPAN) + "：" + spec);
+	}
+	// 个数为 k 的偏移只可能占满不超过 k 的素数的全部余数；2、3、5、7 还要保证轮上有余数可取
+	for (uint32_t p = 2; p <= max<size_t>(7, c.offsets.size()); p++) {
+		if (!miller_rabin_u64(p)) continue;
+		vector<char> hit(p, 0);
+		size_t distinct = 0;
+		for (uint32_t o : c.offsets) {
+			if (!hit[o % p]) distinct++;
+			hit[o % p] = 1;
+		}
+		if (distinct == p) throw invalid_argument("样式不可容许：偏移占满了模 " + to_string(p) + " 的全部余数");
+	}
+	for (uint32_t r = 0; r < CONSTELLATION_WHEEL; r++) {
+		bool coprime = all_of(c.offsets.begin(), c.offsets.end(), [&](uint32_t o) {
+			uint32_t v = (r + o) % CONSTELLATION_WHEEL;
+			return v % 2 && v % 3 && v % 5 && v % 7;
+		});
+		if (coprime) c.residues.push_back(r);
+	}
+	return c;
+}
+
+// n 起的整个星座是否都是质数：大数先对每个成员做一次基2费马检查，全部通过再逐个完整判定
+bool constellation_is_prime(const BigUInt& n, const vector<uint32_t>& offsets) {
+	if (!n.fits_u64()) {
+		for (uint32_t o : offsets) {
+			if (!fermat_base2(n + BigUInt(o))) return false;
+		}
+	}
+	for (uint32_t o : offsets) {
+		if (!is_prime(n + BigUInt(o))) return false;
+	}
+	return true;
+}
+
+// 按从小到大依次把首项 n >= start（last 非空时还要 n <= *last）的前 count 个星座的首项交给 sink（为空时只计数），
+// 返回找到的个数
+long long scan_constellations(const Constellation& c, const BigUInt& start, const BigUInt* last, long long count,
+							  const function<void(const BigUInt&)>& sink, int threads = 0) {
+	if (count <= 0) return 0;
+	PROF_SCOPE("scan_constellations", start.size());
+	const vector<uint32_t>& offsets = c.offsets;
+	uint64_t span = offsets.back();
+	long long emitted = 0;
+	// 成员里有 2、3、5、7 的星座（如孪生 3、5）不在轮上，n < 8 的直接检查
+	for (uint64_t n = 0; n < 8 && emitted < count; n++) {
+		BigUInt v(n);
+		if (v < start || (last && v > *last) || binary_search(c.residues.begin(), c.residues.end(), (uint32_t)n)) continue;
+		if (constellation_is_prime(v, offsets)) {
+			if (sink) sink(v);
+			emitted++;
+		}
+	}
+	if (emitted >= count || (last && *last < BigUInt(8))) return emitted;
+	
+	// 筛选上界：64 位以内的区间筛到 √(上界 + 跨度)（不超过 2^21，筛到了就不必再测），更大的数按比特数取
+	size_t bits = (last ? *last : start).bit_length();
+	uint64_t bound = sieve_bound(bits);
+	bool provable = false;
+	size_t window = min<size_t>(65536, max<size_t>(256, bits * bits / 64));
+	if (last && last->fits_u64() && last->low_u64() <= UINT64_MAX - span) {
+		uint64_t root = integer_root_u64(last->low_u64() + span, 2) + 1;
+		provable = root <= DEEP_SIEVE_PRIME_LIMIT;
+		bound = min<uint64_t>(root, DEEP_SIEVE_PRIME_LIMIT);
+		window = 65536;
+	}
+	const vector<uint32_t>& primes = sieving_primes(bound);
+	const SmallModuli& moduli = sieving_moduli(bound);
+	size_t full_count = lower_bound(primes.begin(), primes.end(), bound) - primes.begin();
+	// 3、5、7 已由轮处理
+	const size_t first_k = 3;
+	
+	BigUInt base0 = start - BigUInt(start.mod_small(CONSTELLATION_WHEEL));
+	if (last) {
+		BigUInt rows = (*last - base0) / BigUInt(CONSTELLATION_WHEEL) + BigUInt(1);
+		if (rows.fits_u64()) window = (size_t)min<uint64_t>(window, rows.low_u64());
+	}
+	BigUInt window_span = BigUInt(CONSTELLATION_WHEEL) * BigUInt(window);
+	int n = worker_count(threads);
+	size_t rows = c.residues.size(), k_count = offsets.size();
+	
+	// minv = 210^(-1)，row_shift[行·full_count + k] = r·210^(-1) mod p
+	vector<uint32_t> minv(full_count), row_shift(rows * full_count);
+	for (size_t k = first_k; k < full_count; k++) {
+		uint32_t p = primes[k];
+		minv[k] = inverse_mod_u32(CONSTELLATION_WHEEL % p, p);
+		for (size_t row = 0; row < rows; row++) row_shift[row * full_count + k] = (uint32_t)((uint64_t)c.residues[row] * minv[k] % p);
+	}
+	
+	atomic<bool> done(false);
+	atomic<long long> total(emitted);
+	mutex turn_mutex;
+	condition_variable turn;
+	uint64_t next_emit = 0;
+	
+	auto worker = [&](int t) {
+		vector<uint32_t> residue(full_count), shift(full_count), column(full_count * k_count);
+		for (size_t k = first_k; k < full_count; k++) shift[k] = (uint32_t)(window_span.mod_small(primes[k]) * n % primes[k]);
+		vector<char> composite(window);
+		vector<uint64_t> survivors, found;
+		survivors.reserve(window);
+		bool first = true;
+		for (uint64_t w = t; !done.load(); w += n) {
+			BigUInt base = base0 + window_span * BigUInt(w);
+			if (last && base > *last) break;
+			if (first) {
+				moduli.residues(base, residue.data(), full_count);
+				first = false;
+			} else {
+				for (size_t k = first_k; k < full_count; k++) residue[k] = (residue[k] + shift[k]) % primes[k];
+			}
+			// 窗口内首项的相对范围 [lo, hi]
+			uint64_t lo = start > base ? (start - base).low_u64() : 0, hi = UINT64_MAX;
+			if (last) {
+				BigUInt room = *last - base;
+				if (room.fits_u64()) hi = room.low_u64();
+			}
+			// 窗口起点小于筛选上界时，成员可能恰好就是筛选素数本身，这一个位置不能划掉
+			uint64_t low_base = base.fits_u64() && base.low_u64() < bound ? base.low_u64() : UINT64_MAX;
+			// 每个 (p, o) 在第 0 行的起点 -(base+o)·210^(-1) mod p
+			for (size_t k = first_k; k < full_count; k++) {
+				uint64_t p = primes[k];
+				for (size_t i = 0; i < k_count; i++) {
+					column[k * k_count + i] = (uint32_t)((p - (residue[k] + offsets[i]) % p) % p * minv[k] % p);
+				}
+			}
+			
+			survivors.clear();
+			for (size_t row = 0; row < rows; row++) {
+				uint32_t r = c.residues[row];
+				fill(composite.begin(), composite.end(), 0);
+				const uint32_t* rs = row_shift.data() + row * full_count;
+				for (size_t k = first_k; k < full_count; k++) {
+					uint32_t p = primes[k];
+					for (size_t i = 0; i < k_count; i++) {
+						uint32_t col = column[k * k_count + i];
+						size_t j = col >= rs[k] ? col - rs[k] : col + p - rs[k];
+						if (low_base != UINT64_MAX && low_base + r + (uint64_t)CONSTELLATION_WHEEL * j + offsets[i] == p) j += p;
+						for (; j < window; j += p) composite[j] = 1;
+					}
+				}
+				for (size_t j = 0; j < window; j++) {
+					uint64_t offset = (uint64_t)j * CONSTELLATION_WHEEL + r;
+					if (!composite[j] && offset >= lo && offset <= hi) survivors.push_back(offset);
+				}
+			}
+			sort(survivors.begin(), survivors.end());
+			
+			found.clear();
+			for (uint64_t offset : survivors) {
+				if (done.load(memory_order_relaxed)) break;
+				// 前面的窗口只会再贡献星座，本窗口已找到的够补足剩余名额就不必再测
+				if ((long long)found.size() >= count - total.load()) break;
+				// 1 与 210 互素也会幸存，但不是质数
+				if (low_base == 0 && offset == 1) continue;
+				if (provable || constellation_is_prime(base + BigUInt(offset), offsets)) found.push_back(offset);
+			}
+			
+			unique_lock<mutex> lock(turn_mutex);
+			turn.wait(lock, [&] { return next_emit == w || done.load(); });
+			if (done.load()) break;
+			for (uint64_t offset : found) {
+				if (total.load() >= count) break;
+				if (sink) sink(base + BigUInt(offset));
+				total++;
+			}
+			if (total.load() >= count) done.store(true);
+			next_emit++;
+			turn.notify_all();
+		}
+	};
+	
+	vector<thread> pool;
+	for (int i = 1; i < n; i++) pool.emplace_back(worker, i);
+	worker(0);
+	for (thread& th : pool) th.join();
+	return total.load();
+}
+
+// [a, b] 中首项落在区间内的全部星座，按从小到大交给 sink（为空时只计数），返回个数
+long long constellations_in(const Constellation& c, const BigUInt& a, const BigUInt& b, const function<void(const BigUInt&)>& sink,
+							int threads = 0) {
+	if (a > b) return 0;
+	return scan_constellations(c, a, &b, LLONG_MAX, sink, threads);
+}
+
+// [lo, hi) 中随机起点之后的第一个星座（首项须小于 hi），走出区间就换起点，区间太窄、反复找不到时返回 false
+bool random_constellation(const Constellation& c, const BigUInt& lo, const BigUInt& hi, mt19937& gen, BigUInt& found, int threads = 0) {
+	BigUInt last = hi - BigUInt(1);
+	for (int attempt = 0; attempt < 64; attempt++) {
+		BigUInt start = lo + random_below(hi - lo, gen);
+		if (scan_constellations(c, start, &last, 1, [&](const BigUInt& v) { found = v; }, threads)) return true;
+	}
+	return false;
+}
+
+// ==================== 因数分解 ====================
+// 依次使用：小素数表试除 -> 完全幂检测 -> Pollard-Brent rho -> 并行 ECM。
+// 每找到一个因子就把两边分别递归分解，余因子先做素性判定，是质数就直接收下。
+
+// 模逆 a^(-1) mod n；不可逆时返回 false，g 中为 gcd(a, n)（大于1时就是 n 的一个因子）
+bool mod_inverse(const BigUInt& a, const BigUInt& n, BigUInt& inv, BigUInt& g) {
+	// 扩展欧几里得：系数 t 的符号严格交替，只记录绝对值和 t1 的符号
+	BigUInt r0 = n, r1 = a % n, t0(0), t1(1);
+	bool t1_negative = false;
+	while (!r1.is_zero()) {
+		BigUInt q, r;
+		BigUInt::divmod(r0, r1, q, r);
+		BigUInt t = t0 + q * t1;
+		r0 = move(r1);
+		r1 = move(r);
+		t0 = move(t1);
+		t1 = move(t);
+		t1_negative = !t1_negative;
+	}
+	g = r0;
+	if (!g.is_one()) return false;
+	// 此时 t0 的符号与 t1 相反
+	t0 = t0 % n;
+	inv = (!t1_negative && !t0.is_zero()) ? n - t0 : t0;
+	return true;
+}
+
+// floor(n^(1/k))（牛顿迭代，从不小于真值的初值单调下降）
+BigUInt integer_root(const BigUInt& n, unsigned k) {
+	if (n.is_zero() || k == 1) return n;
+	BigUInt x = BigUInt(1) << (n.bit_length() / k + 1);
+	while (true) {
+		BigUInt y = (BigUInt(k - 1) * x + n / BigUInt::pow(x, k - 1)) / BigUInt(k);
+		if (y >= x) return x;
+		x = move(y);
+	}
+}
+
+// ---------- Pollard-Brent rho ----------
+// f(y) = y^2 + c；Brent 的倍增找环，每 128 步把 |x - y| 连乘起来只做一次 gcd，
+// gcd 一下子跳到 n 时从这一批的起点逐步回退。全程在 Montgomery 形式下运算，
+// 乘了 R 不改变与 n 的公因子，gcd 可以直接对 Montgomery 形式的值求。
+const uint64_t RHO_BATCH = 128;
+
+// 64位版本，n 为奇合数；失败（结果为 n）时调用方换一个 c 再试
+uint64_t pollard_brent_u64(uint64_t n, uint64_t c) {
+	Mont64 mont(n);
+	uint64_t cm = mont.to_mont(c), y = mont.to_mont(2), x = y, ys = y, q = mont.r1, g = 1;
+	auto f = [&](uint64_t v) {
+		v = mont.mul(v, v);
+		uint64_t r = v + cm;
+		return (r < v || r >= n) ? r - n : r;
+	};
+	auto diff = [](uint64_t a, uint64_t b) { return a > b ? a - b : b - a; };
+	for (uint64_t r = 1; g == 1; r <<= 1) {
+		x = y;
+		for (uint64_t i = 0; i < r; i++) y = f(y);
+		for (uint64_t k = 0; k < r && g == 1; k += RHO_BATCH) {
+			ys = y;
+			for (uint64_t i = 0; i < min(RHO_BATCH, r - k); i++) {
+				y = f(y);
+				q = mont.mul(q, diff(x, y));
+			}
+			g = gcd(q, n);
+		}
+	}
+	if (g == n) {
+		do {
+			ys = f(ys);
+			g = gcd(diff(x, ys), n);
+		} while (g == 1);
+	}
+	return g;
+}
+
+// 多精度版本，最多迭代 max_steps 步；返回非平凡因子，没找到返回 0
+BigUInt pollard_brent(const BigUInt& n, uint64_t c, uint64_t max_steps) {
+	PROF_SCOPE("pollard_brent", n.size());
+	MontContext ctx(n);
+	MontNum cm = ctx.to_mont(BigUInt(c)), y = ctx.to_mont(BigUInt(2)), x, ys, q = ctx.one(), d;
+	auto f = [&](MontNum& v) {
+		ctx.sqr(v, v);
+		ctx.add(v, v, cm);
+	};
+	BigUInt g(1);
+	uint64_t steps = 0;
+	for (uint64_t r = 1; g.is_one() && steps < max_steps; r <<= 1) {
+		x = y;
+		for (uint64_t i = 0; i < r; i++) f(y);
+		steps += r;
+		for (uint64_t k = 0; k < r && g.is_one(); k += RHO_BATCH) {
+			ys = y;
+			for (uint64_t i = 0; i < min(RHO_BATCH, r - k); i++) {
+				f(y);
+				ctx.sub(d, x, y);
+				ctx.mul(q, q, d);
+			}
+			steps += min(RHO_BATCH, r - k);
+			g = BigUInt::gcd(BigUInt::from_limbs(q), n);
+		}
+	}
+	if (g == n) {
+		do {
+			f(ys);
+			ctx.sub(d, x, ys);
+			g = BigUInt::gcd(BigUInt::from_limbs(d), n);
+		} while (g.is_one());
+	}
+	return (g.is_one() || g == n) ? BigUInt(0) : g;
+}
+
+// ---------- 椭圆曲线法（ECM） ----------
+// Montgomery 曲线 By^2 = x^3 + Ax^2 + x，只用射影坐标 X:Z，a24 = (A+2)/4。
+// 第一阶段乘上所有不超过 B1 的素数幂；第二阶段用步长 D = 2310 的大步小步覆盖 (B1, B2] 中的 mD ± j，
+// 小步点预先归一化为仿射 x，每个 (m, j) 只需 2 次乘法。
+
+struct EcmPoint {
+	MontNum X, Z;
+};
+
+class EcmCurve {
+private:
+	const MontContext& ctx;
+	MontNum a24;
+	MontNum s, d, ss, dd, t, u, v;  // 临时量，循环中不再分配
+
+public:
+	EcmCurve(const MontContext& c, const MontNum& a) : ctx(c), a24(a) {}
+
+	// R = 2P：X = (X+Z)^2 (X-Z)^2，Z = 4XZ·((X-Z)^2 + a24·4XZ)
+	void dbl(EcmPoint& R, const EcmPoint& P) {
+		ctx.add(s, P.X, P.Z);
+		ctx.sub(d, P.X, P.Z);
+		ctx.sqr(ss, s);
+		ctx.sqr(dd, d);
+		ctx.sub(t, ss, dd);
+		ctx.mul(R.X, ss, dd);
+		ctx.mul(u, a24, t);
+		ctx.add(u, u, dd);
+		ctx.mul(R.Z, t, u);
+	}
+
+	// R = P + Q，diff = P - Q（R 可以与 P、Q 相同，不能与 diff 相同）
+	void add(EcmPoint& R, const EcmPoint& P, const EcmPoint& Q, const EcmPoint& diff) {
+		ctx.sub(d, P.X, P.Z);
+		ctx.add(s, Q.X, Q.Z);
+		ctx.mul(u, d, s);
+		ctx.add(s, P.X, P.Z);
+		ctx.sub(d, Q.X, Q.Z);
+		ctx.mul(v, s, d);
+		ctx.add(s, u, v);
+		ctx.sub(d, u, v);
+		ctx.sqr(s, s);
+		ctx.sqr(d, d);
+		ctx.mul(R.X, diff.Z, s);
+		ctx.mul(R.Z, diff.X, d);
+	}
+
+	// R = k·P（Montgomery 阶梯，保持 R1 - R0 = P）
+	void mul(EcmPoint& R, const EcmPoint& P, uint64_t k) {
+		EcmPoint base = P, R0 = P, R1;
+		dbl(R1, P);
+		for (int i = 62 - __builtin_clzll(k); i >= 0; i--) {
+			if ((k >> i) & 1) {
+				add(R0, R1, R0, base);
+				dbl(R1, R1);
+			} else {
+				add(R1, R1, R0, base);
+				dbl(R0, R0);
+			}
+		}
+		R = R0;
+	}
+};
+
+// 检查 gcd(x, n)：是非平凡因子则放进 factor
+bool ecm_check(const BigUInt& x, const BigUInt& n, BigUInt& factor) {
+	BigUInt g = BigUInt::gcd(x, n);
+	if (g.is_one() || g == n) return false;
+	factor = g;
+	return true;
+}
+
+const uint64_t ECM_D = 2310;
+
+// 用 Suyama 参数 sigma 跑一条曲线，primes 为不超过 B1 的全部素数；stop 被置位时尽早放弃
+bool ecm_curve(const BigUInt& n, const MontContext& ctx, uint64_t sigma, uint64_t B1, uint64_t B2,
+			   const vector<uint32_t>& primes, BigUInt& factor, const atomic<bool>& stop) {
+	PROF_SCOPE("ecm_curve", n.size());
+	// u = sigma^2 - 5，v = 4·sigma，起点 x0 = u^3，z0 = v^3，a24 = (v-u)^3 (3u+v) / (16 u^3 v)
+	BigUInt sg = BigUInt(sigma) % n;
+	BigUInt u = (sg * sg + n - BigUInt(5) % n) % n, v = (BigUInt(4) * sg) % n;
+	BigUInt u3 = u * u % n * u % n, v3 = v * v % n * v % n;
+	BigUInt vu = (v + n - u) % n;
+	BigUInt num = vu * vu % n * vu % n * ((BigUInt(3) * u + v) % n) % n;
+	BigUInt den = BigUInt(16) * u3 % n * v % n, inv, g;
+	if (!mod_inverse(den, n, inv, g)) {
+		if (g == n) return false;
+		factor = g;
+		return true;
+	}
+	EcmCurve curve(ctx, ctx.to_mont(num * inv % n));
+	EcmPoint P{ctx.to_mont(u3), ctx.to_mont(v3)};
+	
+	// 第一阶段
+	for (size_t i = 0; i < primes.size(); i++) {
+		if (i % 256 == 0 && stop.load(memory_order_relaxed)) return false;
+		uint64_t q = primes[i];
+		while (q * primes[i] <= B1) q *= primes[i];
+		curve.mul(P, P, q);
+	}
+	if (ecm_check(BigUInt::from_limbs(P.Z), n, factor)) return true;
+	if (MontContext::is_zero(P.Z)) return false;
+	
+	// 第二阶段：小步 j 取 [1, D/2) 中与 D 互素的奇数，[j]P 递推得到后用一次求逆全部归一化
+	vector<uint64_t> js;
+	vector<EcmPoint> baby;
+	EcmPoint P2, prev = P, cur = P, next;
+	curve.dbl(P2, P);
+	for (uint64_t j = 1; j < ECM_D / 2; j += 2) {
+		if (gcd(j, ECM_D) == 1) {
+			js.push_back(j);
+			baby.push_back(cur);
+		}
+		// [j+2] = [j] + [2]，差为 [j-2]（j = 1 时差为 [1] 自身）
+		curve.add(next, cur, P2, j == 1 ? P : prev);
+		prev = cur;
+		cur = next;
+	}
+	// Montgomery 批量求逆：前缀积、一次模逆、再倒推出每个 Z 的逆
+	vector<MontNum> prefix(baby.size());
+	prefix[0] = baby[0].Z;
+	for (size_t i = 1; i < baby.size(); i++) ctx.mul(prefix[i], prefix[i - 1], baby[i].Z);
+	BigUInt total = ctx.from_mont(prefix.back());
+	if (!mod_inverse(total, n, inv, g)) {
+		if (g == n) return false;
+		factor = g;
+		return true;
+	}
+	MontNum acc_inv = ctx.to_mont(inv), zinv;
+	vector<MontNum> bx(baby.size());
+	for (size_t i = baby.size(); i-- > 0;) {
+		if (i > 0) {
+			ctx.mul(zinv, acc_inv, prefix[i - 1]);
+			ctx.mul(acc_inv, acc_inv, baby[i].Z);
+		} else {
+			zinv = acc_inv;
+		}
+		ctx.mul(bx[i], baby[i].X, zinv);
+	}
+	
+	// 大步：R_m = [mD]P，R_{m+1} = R_m + [D]P（差为 R_{m-1}）；累乘 X_R - x_j·Z_R
+	uint64_t m0 = max<uint64_t>(1, B1 / ECM_D), m1 = B2 / ECM_D + 1;
+	EcmPoint G, R0, R1, R2;
+	curve.mul(G, P, ECM_D);
+	curve.mul(R0, G, m0);
+	curve.mul(R1, G, m0 + 1);
+	MontNum acc = ctx.one(), t;
+	for (uint64_t m = m0; m <= m1; m++) {
+		if ((m - m0) % 64 == 0 && stop.load(memory_order_relaxed)) return false;
+		for (const MontNum& x : bx) {
+			ctx.mul(t, x, R0.Z);
+			ctx.sub(t, R0.X, t);
+			ctx.mul(acc, acc, t);
+		}
+		curve.add(R2, R1, G, R0);
+		swap(R0, R1);
+		swap(R1, R2);
+	}
+	return ecm_check(BigUInt::from_limbs(acc), n, factor);
+}
+
+// ECM 参数表：目标因子位数、B1、曲线数（B2 取 100·B1）
+struct EcmLevel {
+	int digits;
+	uint64_t B1;
+	int curves;
+};
+const EcmLevel ecm_schedule[] = {
+	{15, 2000, 25}, {20, 11000, 90}, {25, 50000, 300}, {30, 250000, 700},
+	{35, 1000000, 1800}, {40, 3000000, 5100}, {45, 11000000, 10600}, {50, 43000000, 19300}
+};
+
+// 在所有线程上并行跑同一 B1 的 curves 条曲线，任一线程找到因子后置位 stop，其余线程尽快退出
+bool ecm_parallel(const BigUInt& n, uint64_t B1, int curves, int threads, BigUInt& factor) {
+	vector<uint32_t> primes = {2, 3, 5};
+	vector<uint32_t> rest = wheel_sieving_primes((uint32_t)B1);
+	primes.insert(primes.end(), rest.begin(), rest.end());
+	
+	int workers = min(worker_count(threads), curves);
+	vector<uint64_t> seeds(workers);
+	for (uint64_t& seed : seeds) seed = ((uint64_t)rng() << 32) | rng();
+	atomic<int> next_curve(0);
+	atomic<bool> stop(false);
+	mutex found_mutex;
+	auto worker = [&](uint64_t seed) {
+		mt19937_64 gen(seed);
+		// 每个线程自己的 Montgomery 上下文（上下文内部有暂存区，不能共享）
+		MontContext ctx(n);
+		BigUInt f;
+		while (!stop.load() && next_curve.fetch_add(1) < curves) {
+			uint64_t sigma = 6 + gen() % 0xFFFFFFF0ULL;
+			if (ecm_curve(n, ctx, sigma, B1, 100 * B1, primes, f, stop)) {
+				lock_guard<mutex> lock(found_mutex);
+				if (!stop.load()) {
+					factor = f;
+					stop.store(true);
+				}
+			}
+		}
+	};
+	vector<thread> pool;
+	for (int i = 1; i < workers; i++) pool.emplace_back(worker, seeds[i]);
+	worker(seeds[0]);
+	for (thread& t : pool) t.join();
+	return stop.load();
+}
+
+// ---------- 自初始化二次筛（SIQS） ----------
+// 两个因子大小接近的 50-100 位合数上 rho 和 ECM 都很吃力，改用二次筛：
+// 在 Q(x) = (ax+b)^2 - kn = a·g(x) 上筛出因子基上光滑的 g(x)，凑出 X^2 ≡ Y^2 (mod n) 后取 gcd。
+//  - 乘数 k 按 Knuth-Schroeppel 函数挑选，让更多小素数落入因子基；
+//  - a 取 s 个因子基素数之积，同一个 a 下的 2^(s-1) 个 b 按格雷码切换，换多项式只需对根做一次加减；
+//  - 筛区按 32KB 分块（L1 数据缓存大小），不小于块长的素数先按块分桶，每块只扫一遍自己的桶；
+//  - 单大素数变体：余下一个小于 lp_bound 的素数的关系先存起来，同一大素数的两条配成一列；
+//  - 各线程各自挑 a 独立筛，关系汇总后先做结构化高斯消元（去单例、合并低重列），剩下的小矩阵再稠密消元。
+
+const uint32_t SIQS_BLOCK_BITS = 15;
+const uint32_t SIQS_BLOCK = 1u << SIQS_BLOCK_BITS;   // 与 L1 数据缓存大小一致
+const uint32_t SIQS_SMALL_PRIME = 30;               // 更小的素数不筛（命中太密），只在试除时处理
+const size_t SIQS_EXTRA_RELATIONS = 64;
+const double SIQS_THRESHOLD_SLACK = 15;
+const size_t SIQS_MIN_DIGITS = 35;                  // 分解流程中改用 SIQS 的位数范围
+const size_t SIQS_MAX_DIGITS = 120;
+
+struct SiqsParams {
+	int bits;      // n 的比特数
+	int fb_size;   // 因子基大小
+	int lp_mult;   // 大素数上界 = 最大因子基素数 * lp_mult
+	int blocks;    // 筛区总块数：x 取 [-M, M)，2M = blocks * SIQS_BLOCK
+};
+
+// 参数表（两行之间对因子基大小线性插值）
+const SiqsParams siqs_table[] = {
+	{96, 120, 120, 2}, {128, 400, 160, 2}, {160, 1000, 160, 2}, {183, 2000, 160, 4},
+	{200, 3500, 200, 4}, {216, 7500, 200, 6}, {233, 12500, 320, 8}, {249, 20000, 320, 10},
+	{266, 32000, 400, 12}, {283, 45000, 400, 14}, {298, 58000, 480, 16}, {315, 70000, 600, 20},
+	{332, 85000, 600, 24}, {349, 100000, 600, 28}
+};
+
+struct SiqsRelation {
+	BigUInt y;                 // (ax + b) mod n
+	vector<uint32_t> factors;  // Q(x) 的因子基下标，按重数重复出现，0 表示 -1
+	uint64_t large;            // 大素数，完整关系为 1
+};
+
+uint32_t pow_mod_u32(uint32_t a, uint32_t e, uint32_t p) {
+	uint64_t r = 1, x = a % p;
+	for (; e; e >>= 1, x = x * x % p) {
+		if (e & 1) r = r * x % p;
+	}
+	return (uint32_t)r;
+}
+
+// a^(-1) mod p，a 与 p 互素
+uint32_t inverse_mod_u32(uint32_t a, uint32_t p) {
+	int64_t r0 = p, r1 = a % p, t0 = 0, t1 = 1;
+	while (r1) {
+		int64_t q = r0 / r1;
+		r0 -= q * r1;
+		swap(r0, r1);
+		t0 -= q * t1;
+		swap(t0, t1);
+	}
+	return (uint32_t)(t0 < 0 ? t0 + p : t0);
+}
+
+// 奇素数 p 下 a 的平方根（Tonelli-Shanks），a 须为二次剩余
+uint32_t sqrt_mod_u32(uint32_t a, uint32_t p) {
+	a %= p;
+	if (a == 0 || p == 2) return a;
+	if (p % 4 == 3) return pow_mod_u32(a, (p + 1) / 4, p);
+	uint32_t q = p - 1, s = 0;
+	while (q % 2 == 0) {
+		q /= 2;
+		s++;
+	}
+	uint32_t z = 2;
+	while (pow_mod_u32(z, (p - 1) / 2, p) != p - 1) z++;
+	uint64_t c = pow_mod_u32(z, q, p), r = pow_mod_u32(a, (q + 1) / 2, p), t = pow_mod_u32(a, q, p);
+	uint32_t m = s;
+	while (t != 1) {
+		uint32_t i = 0;
+		for (uint64_t t2 = t; t2 != 1; t2 = t2 * t2 % p) i++;
+		uint64_t b = c;
+		for (uint32_t j = 0; j + i + 1 < m; j++) b = b * b % p;
+		r = r * b % p;
+		c = b * b % p;
+		t = t * c % p;
+		m = i;
+	}
+	return (uint32_t)r;
+}
+
+// 有符号加法：(neg ? -x : x) += (y_neg ? -y : y)
+void signed_add(BigUInt& x, bool& neg, const BigUInt& y, bool y_neg) {
+	if (neg == y_neg) {
+		x += y;
+	} else if (x >= y) {
+		x -= y;
+		if (x.is_zero()) neg = false;
+	} else {
+		x = y - x;
+		neg = y_neg;
+	}
+}
+
+// 两个有序集合的对称差
+vector<uint32_t> symmetric_difference(const vector<uint32_t>& a, const vector<uint32_t>& b) {
+	vector<uint32_t> r;
+	r.reserve(a.size() + b.size());
+	set_symmetric_difference(a.begin(), a.end(), b.begin(), b.end(), back_inserter(r));
+	return r;
+}
+
+// GF(2) 上的线性相关：rows[i] 为第 i 行中取值为 1 的列（有序），返回至多64组和为零的行下标集合。
+// 先做结构化高斯消元：删掉含只出现一次的列的行，把只出现在少数几行中的列并入其中最轻的一行后消去；
+// 剩下的小矩阵转置成按列存放的位矩阵做稠密高斯-若尔当消元，每个自由变量对应一组相关。
+const size_t SGE_MAX_MERGE = 16;       // 只合并出现次数不超过它的列
+const size_t SGE_MAX_ROW_WEIGHT = 512; // 主元行太重就不再合并，避免填充失控
+
+vector<vector<uint32_t>> gf2_dependencies(const vector<vector<uint32_t>>& input, size_t ncols) {
+	PROF_SCOPE("gf2_dependencies", input.size() / 64);
+	struct SgeRow {
+		vector<uint32_t> cols;
+		vector<uint32_t> origin;  // 合成这一行的原始行（有序）
+		bool alive;
+	};
+	vector<SgeRow> rows(input.size());
+	for (size_t i = 0; i < input.size(); i++) rows[i] = {input[i], {(uint32_t)i}, true};
+	
+	vector<vector<uint32_t>> where(ncols);
+	for (bool changed = true; changed;) {
+		changed = false;
+		for (auto& w : where) w.clear();
+		for (size_t r = 0; r < rows.size(); r++) {
+			if (!rows[r].alive) continue;
+			for (uint32_t c : rows[r].cols) where[c].push_back((uint32_t)r);
+		}
+		vector<uint32_t> order;
+		for (size_t c = 0; c < ncols; c++) {
+			if (!where[c].empty() && where[c].size() <= SGE_MAX_MERGE) order.push_back((uint32_t)c);
+		}
+		sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return where[a].size() < where[b].size(); });
+		// 本轮改动过的行的列表已过期，涉及它们的列留到下一轮
+		vector<char> touched(rows.size(), 0);
+		for (uint32_t c : order) {
+			const vector<uint32_t>& w = where[c];
+			if (any_of(w.begin(), w.end(), [&](uint32_t r) { return touched[r]; })) continue;
+			uint32_t pivot = *min_element(w.begin(), w.end(), [&](uint32_t a, uint32_t b) {
+				return rows[a].cols.size() < rows[b].cols.size();
+			});
+			if (w.size() > 1 && rows[pivot].cols.size() > SGE_MAX_ROW_WEIGHT) continue;
+			for (uint32_t r : w) {
+				touched[r] = 1;
+				if (r == pivot) continue;
+				rows[r].cols = symmetric_difference(rows[r].cols, rows[pivot].cols);
+				rows[r].origin = symmetric_difference(rows[r].origin, rows[pivot].origin);
+			}
+			rows[pivot].alive = false;
+			changed = true;
+		}
+	}
+	
+	// 剩余的行和列重新编号；行数只需比列数多出 SIQS_EXTRA_RELATIONS，多余的重行丢掉
+	vector<uint32_t> alive;
+	for (size_t r = 0; r < rows.size(); r++) {
+		if (rows[r].alive) alive.push_back((uint32_t)r);
+	}
+	vector<uint32_t> col_index(ncols, UINT32_MAX);
+	size_t active = 0;
+	for (size_t c = 0; c < ncols; c++) {
+		if (!where[c].empty()) col_index[c] = (uint32_t)active++;
+	}
+	if (alive.size() > active + SIQS_EXTRA_RELATIONS) {
+		sort(alive.begin(), alive.end(), [&](uint32_t a, uint32_t b) { return rows[a].cols.size() < rows[b].cols.size(); });
+		alive.resize(active + SIQS_EXTRA_RELATIONS);
+	}
+	size_t R = alive.size(), words = (R + 63) / 64;
+	
+	// 位矩阵：每个活跃列一行，第 j 位表示 alive[j] 是否含有该列
+	vector<vector<uint64_t>> mat(active, vector<uint64_t>(words, 0));
+	for (size_t j = 0; j < R; j++) {
+		for (uint32_t c : rows[alive[j]].cols) mat[col_index[c]][j / 64] |= 1ULL << (j % 64);
+	}
+	vector<size_t> pivot_col;
+	vector<char> is_pivot(R, 0);
+	size_t rank = 0;
+	for (size_t j = 0; j < R && rank < active; j++) {
+		uint64_t bit = 1ULL << (j % 64);
+		size_t w = j / 64, p = rank;
+		while (p < active && !(mat[p][w] & bit)) p++;
+		if (p == active) continue;
+		swap(mat[rank], mat[p]);
+		const vector<uint64_t>& prow = mat[rank];
+		for (size_t i = 0; i < active; i++) {
+			if (i != rank && (mat[i][w] & bit)) {
+				uint64_t* row = mat[i].data();
+				for (size_t k = 0; k < words; k++) row[k] ^= prow[k];
+			}
+		}
+		pivot_col.push_back(j);
+		is_pivot[j] = 1;
+		rank++;
+	}
+	
+	// 自由变量 f 置 1：各主元变量等于其所在行在 f 列上的值
+	vector<vector<uint32_t>> deps;
+	for (size_t f = 0; f < R && deps.size() < 64; f++) {
+		if (is_pivot[f]) continue;
+		vector<uint32_t> origin = rows[alive[f]].origin;
+		for (size_t i = 0; i < rank; i++) {
+			if (mat[i][f / 64] >> (f % 64) & 1) origin = symmetric_difference(origin, rows[alive[pivot_col[i]]].origin);
+		}
+		if (!origin.empty()) deps.push_back(move(origin));
+	}
+	return deps;
+}
+
+class QuadraticSieve {
+private:
+	BigUInt n, kn;
+	uint32_t k;
+	int threads;
+	SiqsParams params;
+	uint32_t M;                  // 半区间长度
+	vector<uint32_t> fb;         // 因子基：fb[0] 占位表示 -1，fb[1] = 2
+	vector<uint32_t> fb_sqrt;    // sqrt(kn) mod p
+	vector<uint8_t> fb_log;      // 缩放后的 log2(p)
+	vector<uint32_t> fb_mmod;    // M mod p
+	size_t first_sieved;         // 第一个参与筛的下标
+	size_t first_large;          // 第一个不小于块长、按桶筛的下标
+	uint8_t sieve_init;          // 筛数组初值：累加的对数超过阈值时最高位变为 1
+	uint64_t lp_bound;
+	
+	mutex store_mutex;
+	vector<SiqsRelation> fulls;
+	unordered_map<uint64_t, vector<SiqsRelation>> partials;
+	unordered_set<uint64_t> seen;  // 已收录关系的 y 的摘要，用于去重
+	size_t cycles = 0;             // 部分关系能配成的列数
+	atomic<bool> done{false};
+	chrono::steady_clock::time_point last_report;
+	
+	void choose_multiplier();
+	void build_factor_base();
+	vector<size_t> choose_a(mt19937_64& gen) const;
+	void store(vector<SiqsRelation>& found);
+	void sieve_worker(uint64_t seed);
+	bool solve(BigUInt& factor);
+
+public:
+	QuadraticSieve(const BigUInt& number, int thread_count) : n(number), threads(worker_count(thread_count)) {}
+	bool run(BigUInt& factor);
+};
+
+// Knuth-Schroeppel：f(k) = Σ g(p,kn)·log p - log(k)/2，取 f 最大的无平方因子乘数 k
+void QuadraticSieve::choose_multiplier() {
+	static const uint32_t multipliers[] = {1, 2, 3, 5, 6, 7, 10, 11, 13, 14, 15, 17, 19, 21, 22, 23, 26, 29,
+										   30, 31, 33, 34, 35, 37, 38, 39, 41, 42, 43, 46, 47, 51, 53, 55, 57, 58,
+										   59, 61, 62, 65, 66, 67, 69, 70, 71, 73};
+	vector<uint32_t> primes = sieve_primes();
+	primes.resize(min<size_t>(primes.size(), 300));
+	vector<uint32_t> n_mod(primes.size());
+	sieving_moduli(SIEVE_PRIME_LIMIT).residues(n, n_mod.data(), n_mod.size());
+	uint32_t n8 = (uint32_t)(n.low_u64() % 8);
+	double best = -1e300;
+	for (uint32_t m : multipliers) {
+		double score = -0.5 * log((double)m);
+		uint32_t kn8 = m * n8 % 8;
+		if (kn8 == 1) score += 2 * log(2.0);
+		else if (kn8 == 5) score += log(2.0);
+		else if (kn8 == 3 || kn8 == 7) score += 0.5 * log(2.0);
+		for (size_t i = 0; i < primes.size(); i++) {
+			uint32_t p = primes[i];
+			double lp = log((double)p);
+			if (m % p == 0) {
+				score += lp / p;
+			} else if (jacobi_u64((uint64_t)m * n_mod[i] % p, p) == 1) {
+				score += 2 * lp / (p - 1);
+			}
+		}
+		if (score > best) {
+			best = score;
+			k = m;
+		}
+	}
+	kn = n * BigUInt(k);
+}
+
+void QuadraticSieve::build_factor_base() {
+	// 参数按 n 的比特数查表插值
+	int bits = (int)n.bit_length();
+	size_t rows = size(siqs_table);
+	params = siqs_table[rows - 1];
+	if (bits <= siqs_table[0].bits) {
+		params = siqs_table[0];
+	} else {
+		for (size_t i = 0; i + 1 < rows; i++) {
+			const SiqsParams &lo = siqs_table[i], &hi = siqs_table[i + 1];
+			if (bits > hi.bits) continue;
+			params = lo;
+			params.fb_size = lo.fb_size + (hi.fb_size - lo.fb_size) * (bits - lo.bits) / (hi.bits - lo.bits);
+			break;
+		}
+	}
+	M = params.blocks * SIQS_BLOCK / 2;
+	
+	// 因子基：-1、2，以及使 kn 为二次剩余（或整除 k）的奇素数
+	fb = {1, 2};
+	for (uint32_t limit = 1 << 16; fb.size() < (size_t)params.fb_size; limit *= 2) {
+		fb.resize(2);
+		vector<uint32_t> candidates = {3, 5};
+		vector<uint32_t> rest = wheel_sieving_primes(limit);
+		candidates.insert(candidates.end(), rest.begin(), rest.end());
+		for (uint32_t p : candidates) {
+			uint32_t r = (uint32_t)kn.mod_small(p);
+			if (r == 0 || jacobi_u64(r, p) == 1) fb.push_back(p);
+			if (fb.size() == (size_t)params.fb_size) break;
+		}
+	}
+	size_t F = fb.size();
+	fb_sqrt.assign(F, 0);
+	fb_mmod.assign(F, 0);
+	for (size_t i = 2; i < F; i++) {
+		fb_sqrt[i] = sqrt_mod_u32((uint32_t)kn.mod_small(fb[i]), fb[i]);
+		fb_mmod[i] = M % fb[i];
+	}
+	first_sieved = 2;
+	while (first_sieved < F && fb[first_sieved] < SIQS_SMALL_PRIME) first_sieved++;
+	first_large = first_sieved;
+	while (first_large < F && fb[first_large] < SIQS_BLOCK) first_large++;
+	
+	// 阈值：log2|g(x)| 的上界 log2(M·sqrt(kn/2)) 减去允许剩下的大素数，再放宽 SIQS_THRESHOLD_SLACK 比特
+	// （区间中部的 g(x) 远小于上界，没筛的小素数和素数幂也有贡献；多试除一些候选比漏掉关系划算）。
+	// 对数按比例缩放到阈值不超过 100，初值 128 - 阈值，超过阈值的位置最高位为 1，扫描时一次看 8 字节。
+	// 大素数上界不超过最大因子基素数的平方，保证剩下的余数一定是素数。
+	uint64_t pmax = fb.back();
+	lp_bound = min(pmax * params.lp_mult, pmax * pmax);
+	double max_bits = log2((double)M) + ((double)kn.bit_length() - 1) / 2;
+	double threshold = max_bits - log2((double)lp_bound) - SIQS_THRESHOLD_SLACK;
+	double scale = threshold > 100 ? 100 / threshold : 1;
+	sieve_init = (uint8_t)(128 - (int)lround(threshold * scale));
+	fb_log.assign(F, 0);
+	for (size_t i = 1; i < F; i++) fb_log[i] = (uint8_t)lround(log2((double)fb[i]) * scale);
+}
+
+// 挑 a 的素因子（因子基下标）：a 应接近 sqrt(2kn)/M，各因子取在因子基中段、约 11 比特左右，
+// 前 s-1 个在目标大小附近随机取，最后一个取使乘积最接近目标的素数
+vector<size_t> QuadraticSieve::choose_a(mt19937_64& gen) const {
+	size_t F = fb.size();
+	double target = ((double)kn.bit_length() + 1) / 2 - log2((double)M);
+	size_t lo = first_sieved;
+	while (lo + 1 < F && fb[lo] < min<uint32_t>(400, fb[F / 2])) lo++;
+	double lo_bits = log2((double)fb[lo]), hi_bits = log2((double)fb[F - 1]) - 1;
+	int s = max(2, (int)lround(target / 11.5));
+	while (target / s > hi_bits && s < 30) s++;
+	while (s > 2 && target / s < lo_bits) s--;
+	double ideal = pow(2.0, target / s);
+	size_t center = lower_bound(fb.begin() + lo, fb.end(), (uint32_t)min(ideal, (double)fb[F - 1])) - fb.begin();
+	center = min(center, F - 1);
+	size_t span = max<size_t>(10, 3 * s);
+	size_t from = center > lo + span ? center - span : lo, to = min(F - 1, center + span);
+	
+	vector<size_t> q;
+	for (int attempt = 0; attempt < 100; attempt++) {
+		q.clear();
+		double bits = 0;
+		while ((int)q.size() < s - 1) {
+			size_t i = from + gen() % (to - from + 1);
+			if (find(q.begin(), q.end(), i) != q.end()) continue;
+			q.push_back(i);
+			bits += log2((double)fb[i]);
+		}
+		double rest = pow(2.0, target - bits);
+		if (rest < fb[lo] || rest > fb[F - 1]) continue;
+		size_t last = lower_bound(fb.begin() + lo, fb.end(), (uint32_t)rest) - fb.begin();
+		if (last > lo && rest - fb[last - 1] < fb[min(last, F - 1)] - rest) last--;
+		last = min(last, F - 1);
+		while (find(q.begin(), q.end(), last) != q.end() && last + 1 < F) last++;
+		if (find(q.begin(), q.end(), last) != q.end()) continue;
+		q.push_back(last);
+		break;
+	}
+	// 罕见情况下凑不到目标附近，就直接用挑好的 s-1 个再补一个中位的
+	while ((int)q.size() < s) {
+		size_t i = from + gen() % (to - from + 1);
+		if (find(q.begin(), q.end(), i) == q.end()) q.push_back(i);
+	}
+	sort(q.begin(), q.end());
+	return q;
+}
+
+// 把一批新关系并入共享存储；关系够了就置位 done
+void QuadraticSieve::store(vector<SiqsRelation>& found) {
+	lock_guard<mutex> lock(store_mutex);
+	for (SiqsRelation& rel : found) {
+		uint64_t key = rel.y.low_u64() ^ (rel.y.size() > 1 ? rel.y.limb(1) * 0x9E3779B97F4A7C15ULL : 0);
+		if (!seen.insert(key).second) continue;
+		if (rel.large == 1) {
+			fulls.push_back(move(rel));
+		} else {
+			vector<SiqsRelation>& group = partials[rel.large];
+			if (!group.empty()) cycles++;
+			group.push_back(move(rel));
+		}
+	}
+	found.clear();
+	size_t have = fulls.size() + cycles, need = fb.size() + SIQS_EXTRA_RELATIONS;
+	if (have >= need) done.store(true);
+	// 大数要筛很久，每秒在标准错误上刷新一次进度
+	auto now = chrono::steady_clock::now();
+	if (n.bit_length() >= 200 && (now - last_report > chrono::seconds(1) || done.load())) {
+		last_report = now;
+		cerr << "\rSIQS: " << have << "/" << need << " 关系（完整 " << fulls.size() << "，配对 " << cycles << "）"
+			 << (done.load() ? "\n" : "") << flush;
+	}
+}
+
+void QuadraticSieve::sieve_worker(uint64_t seed) {
+	mt19937_64 gen(seed);
+	size_t F = fb.size();
+	uint32_t interval = 2 * M, blocks = params.blocks;
+	vector<uint8_t> sieve(SIQS_BLOCK);
+	vector<uint32_t> soln1(F), soln2(F), root1(F), root2(F), next1(F), next2(F);
+	vector<vector<uint32_t>> bainv;                 // bainv[l][i] = 2·B_l·a^(-1) mod p_i
+	vector<vector<uint32_t>> buckets(blocks);       // 大素数命中：(因子基下标 << 15) | 块内偏移
+	vector<char> is_q(F, 0);
+	vector<SiqsRelation> found;
+	
+	while (!done.load()) {
+		vector<size_t> q = choose_a(gen);
+		size_t s = q.size();
+		BigUInt a(1);
+		for (size_t i : q) {
+			a *= BigUInt(fb[i]);
+			is_q[i] = 1;
+		}
+		// B_l = (a/q_l)·[t_l·(a/q_l)^(-1) mod q_l]，满足 B_l^2 ≡ kn (mod q_l)，且被其余 q 整除
+		vector<BigUInt> B(s);
+		BigUInt b(0);
+		bool b_neg = false;
+		for (size_t l = 0; l < s; l++) {
+			uint32_t p = fb[q[l]];
+			BigUInt aq = a / BigUInt(p);
+			uint64_t g = (uint64_t)fb_sqrt[q[l]] * inverse_mod_u32((uint32_t)aq.mod_small(p), p) % p;
+			if (g > p / 2) g = p - g;
+			B[l] = aq * BigUInt(g);
+			b += B[l];
+		}
+		// 初始根 x ≡ a^(-1)(±t - b) (mod p)
+		bainv.resize(s);
+		for (auto& row : bainv) row.resize(F);
+		for (size_t i = first_sieved; i < F; i++) {
+			if (is_q[i]) continue;
+			uint32_t p = fb[i];
+			uint64_t amod = 1, bmod = 0;
+			for (size_t l = 0; l < s; l++) amod = amod * (fb[q[l]] % p) % p;
+			uint64_t ainv = inverse_mod_u32((uint32_t)amod, p);
+			for (size_t l = 0; l < s; l++) {
+				uint64_t Bl = B[l].mod_small(p);
+				bmod += Bl;
+				bainv[l][i] = (uint32_t)(2 * Bl % p * ainv % p);
+			}
+			bmod %= p;
+			soln1[i] = (uint32_t)(ainv * ((fb_sqrt[i] + p - bmod) % p) % p);
+			soln2[i] = (uint32_t)(ainv * ((2 * (uint64_t)p - fb_sqrt[i] - bmod) % p) % p);
+		}
+		
+		for (uint32_t poly = 0; poly < (1u << (s - 1)) && !done.load(); poly++) {
+			if (poly > 0) {
+				// 格雷码：第 v 位翻转即 B_{v+1} 变号；b 减 2B 时根加 bainv，反之减
+				int v = __builtin_ctz(poly);
+				bool minus = ((poly ^ (poly >> 1)) >> v) & 1;
+				signed_add(b, b_neg, B[v + 1] + B[v + 1], minus);
+				const vector<uint32_t>& delta = bainv[v + 1];
+				for (size_t i = first_sieved; i < F; i++) {
+					if (is_q[i]) continue;
+					uint32_t p = fb[i];
+					if (minus) {
+						soln1[i] += delta[i];
+						if (soln1[i] >= p) soln1[i] -= p;
+						soln2[i] += delta[i];
+						if (soln2[i] >= p) soln2[i] -= p;
+					} else {
+						soln1[i] += p - delta[i];
+						if (soln1[i] >= p) soln1[i] -= p;
+						soln2[i] += p - delta[i];
+						if (soln2[i] >= p) soln2[i] -= p;
+					}
+				}
+			}
+			
+			// 根换成筛区下标（x = 下标 - M），大素数的命中先分到各块的桶里
+			for (auto& bucket : buckets) bucket.clear();
+			for (size_t i = first_sieved; i < F; i++) {
+				if (is_q[i]) continue;
+				uint32_t p = fb[i];
+				uint32_t r1 = soln1[i] + fb_mmod[i], r2 = soln2[i] + fb_mmod[i];
+				if (r1 >= p) r1 -= p;
+				if (r2 >= p) r2 -= p;
+				root1[i] = next1[i] = r1;
+				root2[i] = next2[i] = r2;
+				if (i < first_large) continue;
+				uint32_t tag = (uint32_t)i << SIQS_BLOCK_BITS;
+				for (uint32_t pos = r1; pos < interval; pos += p) buckets[pos >> SIQS_BLOCK_BITS].push_back(tag | (pos & (SIQS_BLOCK - 1)));
+				if (r2 == r1) continue;
+				for (uint32_t pos = r2; pos < interval; pos += p) buckets[pos >> SIQS_BLOCK_BITS].push_back(tag | (pos & (SIQS_BLOCK - 1)));
+			}
+			
+			for (uint32_t blk = 0; blk < blocks; blk++) {
+				uint32_t base = blk * SIQS_BLOCK, end = base + SIQS_BLOCK;
+				memset(sieve.data(), sieve_init, SIQS_BLOCK);
+				uint8_t* sv = sieve.data() - base;
+				for (size_t i = first_sieved; i < first_large; i++) {
+					if (is_q[i]) continue;
+					uint32_t p = fb[i];
+					uint8_t lg = fb_log[i];
+					uint32_t pos = next1[i];
+					for (; pos < end; pos += p) sv[pos] += lg;
+					next1[i] = pos;
+					if (root2[i] == root1[i]) continue;
+					pos = next2[i];
+					for (; pos < end; pos += p) sv[pos] += lg;
+					next2[i] = pos;
+				}
+				const vector<uint32_t>& bucket = buckets[blk];
+				for (uint32_t e : bucket) sieve[e & (SIQS_BLOCK - 1)] += fb_log[e >> SIQS_BLOCK_BITS];
+				
+				// 扫描最高位为 1 的位置，逐个试除
+				for (uint32_t j0 = 0; j0 < SIQS_BLOCK; j0 += 8) {
+					uint64_t word;
+					memcpy(&word, sieve.data() + j0, 8);
+					if (!(word & 0x8080808080808080ULL)) continue;
+					for (uint32_t j = j0; j < j0 + 8; j++) {
+						if (!(sieve[j] & 0x80)) continue;
+						uint32_t gi = base + j;
+						int64_t x = (int64_t)gi - M;
+						// Y = ax + b，Q = Y^2 - kn = a·g(x)
+						BigUInt Y = a * BigUInt((uint64_t)(x < 0 ? -x : x));
+						bool y_neg = x < 0;
+						signed_add(Y, y_neg, b, b_neg);
+						BigUInt Q = Y.sqr();
+						bool q_neg = Q < kn;
+						Q = q_neg ? kn - Q : Q - kn;
+						BigUInt g = Q / a;
+						if (g.is_zero()) continue;
+						SiqsRelation rel;
+						if (q_neg) rel.factors.push_back(0);
+						size_t twos = g.trailing_zeros();
+						rel.factors.insert(rel.factors.end(), twos, 1);
+						g >>= twos;
+						auto divide_out = [&](size_t i) {
+							while (g.mod_small(fb[i]) == 0) {
+								g.divmod_small(fb[i]);
+								rel.factors.push_back((uint32_t)i);
+							}
+						};
+						for (size_t i = 2; i < first_sieved; i++) divide_out(i);
+						for (size_t i : q) divide_out(i);
+						for (size_t i = first_sieved; i < first_large; i++) {
+							if (is_q[i]) continue;
+							uint32_t r = gi % fb[i];
+							if (r == root1[i] || r == root2[i]) divide_out(i);
+						}
+						for (uint32_t e : bucket) {
+							if ((e & (SIQS_BLOCK - 1)) == j) divide_out(e >> SIQS_BLOCK_BITS);
+						}
+						if (g.is_one()) {
+							rel.large = 1;
+						} else if (g.fits_u64() && g.low_u64() < lp_bound) {
+							// 剩下的数小于最大因子基素数的平方，必为素数
+							rel.large = g.low_u64();
+						} else {
+							continue;
+						}
+						for (size_t i : q) rel.factors.push_back((uint32_t)i);
+						rel.y = Y % n;
+						found.push_back(move(rel));
+					}
+				}
+			}
+		}
+		for (size_t i : q) is_q[i] = 0;
+		store(found);
+	}
+}
+
+// 组列、消元，逐个相关组尝试 gcd(X - Y, n)
+bool QuadraticSieve::solve(BigUInt& factor) {
+	PROF_SCOPE("siqs_solve", n.size());
+	// 完整关系单独成列；同一大素数的部分关系都与该组第一条配对，大素数在列中出现两次而消去
+	vector<vector<const SiqsRelation*>> columns;
+	for (const SiqsRelation& rel : fulls) columns.push_back({&rel});
+	for (const auto& group : partials) {
+		for (size_t j = 1; j < group.second.size(); j++) columns.push_back({&group.second[0], &group.second[j]});
+	}
+	vector<vector<uint32_t>> rows(columns.size());
+	vector<uint32_t> parity(fb.size(), 0);
+	for (size_t c = 0; c < columns.size(); c++) {
+		for (const SiqsRelation* rel : columns[c]) {
+			for (uint32_t i : rel->factors) parity[i] ^= 1;
+		}
+		for (const SiqsRelation* rel : columns[c]) {
+			for (uint32_t i : rel->factors) {
+				if (parity[i]) {
+					rows[c].push_back(i);
+					parity[i] = 0;
+				}
+			}
+		}
+		sort(rows[c].begin(), rows[c].end());
+	}
+	
+	vector<uint32_t> exponents(fb.size());
+	for (const vector<uint32_t>& dep : gf2_dependencies(rows, fb.size())) {
+		// X = Π y，Y = Π p^(e/2) · Π 大素数（每列出现两次，开方后一次）
+		fill(exponents.begin(), exponents.end(), 0);
+		BigUInt X(1), Y(1);
+		for (uint32_t c : dep) {
+			for (const SiqsRelation* rel : columns[c]) {
+				X = X * rel->y % n;
+				for (uint32_t i : rel->factors) exponents[i]++;
+			}
+			if (columns[c].size() == 2) Y = Y * BigUInt(columns[c][0]->large) % n;
+		}
+		for (size_t i = 1; i < fb.size(); i++) {
+			for (uint32_t e = 0; e < exponents[i] / 2; e++) Y = Y * BigUInt(fb[i]) % n;
+		}
+		BigUInt g = BigUInt::gcd((X + n - Y) % n, n);
+		if (!g.is_one() && g != n) {
+			factor = g;
+			return true;
+		}
+	}
+	return false;
+}
+
+// 分解奇合数 n（不是完全幂），成功时 factor 为 n 的非平凡因子
+bool QuadraticSieve::run(BigUInt& factor) {
+	PROF_SCOPE("siqs", n.size());
+	choose_multiplier();
+	build_factor_base();
+	// 因子基里直接出现 n 的因子（n 很小时可能）
+	for (size_t i = 1; i < fb.size(); i++) {
+		if (n.mod_small(fb[i]) == 0 && n != BigUInt(fb[i])) {
+			factor = BigUInt(fb[i]);
+			return true;
+		}
+	}
+	last_report = chrono::steady_clock::now();
+	vector<uint64_t> seeds(threads);
+	for (uint64_t& seed : seeds) seed = ((uint64_t)rng() << 32) | rng();
+	vector<thread> pool;
+	for (int i = 1; i < threads; i++) pool.emplace_back(&QuadraticSieve::sieve_worker, this, seeds[i]);
+	sieve_worker(seeds[0]);
+	for (thread& t : pool) t.join();
+	return solve(factor);
+}
+
+// ---------- 分解流程 ----------
+
+// 求奇合数 n（已无 2^16 以下的因子、不是完全幂）的一个非平凡因子
+BigUInt find_factor(const BigUInt& n, int threads) {
+	// rho 找10位左右以内的因子很快，先跑一小段
+	for (uint64_t c = 1; c <= 3; c++) {
+		BigUInt d = pollard_brent(n, c, 1 << 17);
+		if (!d.is_zero()) return d;
+	}
+	BigUInt factor;
+	// 35-120 位：先用 ECM 扫掉约 2/9 位数以内的因子（此时 ECM 的期望代价还低于二次筛），再交给 SIQS
+	size_t digits = n.bit_length() * 30103 / 100000 + 1;
+	if (digits >= SIQS_MIN_DIGITS && digits <= SIQS_MAX_DIGITS) {
+		for (const EcmLevel& e : ecm_schedule) {
+			if ((size_t)e.digits * 9 > digits * 2) break;
+			if (ecm_parallel(n, e.B1, e.curves, threads, factor)) return factor;
+		}
+		if (QuadraticSieve(n, threads).run(factor)) return factor;
+	}
+	// 参数表逐级加大；跑完最后一级仍没找到就一直重复最后一级
+	for (size_t level = 0;; level = min(level + 1, size(ecm_schedule) - 1)) {
+		const EcmLevel& e = ecm_schedule[level];
+		if (ecm_parallel(n, e.B1, e.curves, threads, factor)) return factor;
+	}
+}
+
+// 把 n 的分解以 mult 重数累加到 factors 中（n 已无 2^16 以下的因子）
+void factor_into(const BigUInt& n, map<BigUInt, int>& factors, int mult, int threads) {
+	if (n.is_one()) return;
+	if (is_prime(n)) {
+		factors[n] += mult;
+		return;
+	}
+	if (n.fits_u64()) {
+		uint64_t v = n.low_u64(), d = v;
+		for (uint64_t c = 1; d == v; c++) d = pollard_brent_u64(v, c);
+		factor_into(BigUInt(d), factors, mult, threads);
+		factor_into(BigUInt(v / d), factors, mult, threads);
+		return;
+	}
+	// 完全幂：所有素因子都大于 2^16，指数 k 不会超过 比特数/16
+	for (unsigned k : {2u, 3u, 5u, 7u, 11u, 13u, 17u, 19u, 23u, 29u, 31u}) {
+		if (k > n.bit_length() / 16) break;
+		BigUInt r = integer_root(n, k);
+		if (BigUInt::pow(r, k) == n) {
+			factor_into(r, factors, mult * k, threads);
+			return;
+		}
+	}
+	BigUInt d = find_factor(n, threads);
+	factor_into(d, factors, mult, threads);
+	factor_into(n / d, factors, mult, threads);
+}
+
+// 完整分解 n（n >= 2），返回按从小到大排列的 (素因子, 指数)
+vector<pair<BigUInt, int>> factorize(BigUInt n, int threads = 0) {
+	PROF_SCOPE("factorize", n.size());
+	map<BigUInt, int> factors;
+	if (n < BigUInt(2)) return {};
+	
+	// 试除：先去掉2，再用筛好的奇素数表
+	size_t twos = n.trailing_zeros();
+	if (twos) {
+		factors[BigUInt(2)] = (int)twos;
+		n >>= twos;
+	}
+	// 余数一遍全部算出：n 除掉某个小素因子后，其余小素数是否整除它并不改变
+	const SmallModuli& moduli = sieving_moduli(SIEVE_PRIME_LIMIT);
+	vector<uint32_t> residue = moduli.residues(n);
+	for (size_t i = 0; i < moduli.size(); i++) {
+		uint32_t p = moduli[i];
+		if (n.fits_u64() && (uint64_t)p * p > n.low_u64()) break;
+		if (residue[i] == 0) factors[BigUInt(p)] = (int)n.remove_factor(p);
+	}
+	if (n.fits_u64() && n.low_u64() > 1 && n.low_u64() < (uint64_t)SIEVE_PRIME_LIMIT * SIEVE_PRIME_LIMIT) {
+		// 剩下的数没有不超过其平方根的因子，本身就是质数
+		factors[n]++;
+	} else {
+		factor_into(n, factors, 1, threads);
+	}
+	return vector<pair<BigUInt, int>>(factors.begin(), factors.end());
+}
+
+// 2^3 × 3 × 5 形式
+string format_factorization(const vector<pair<BigUInt, int>>& factors) {
+	string s;
+	for (const auto& f : factors) {
+		if (!s.empty()) s += " × ";
+		s += f.first.to_string();
+		if (f.second > 1) s += "^" + to_string(f.second);
+	}
+	return s;
+}
+
+// ==================== 可复现的生成基准 ====================
+// 全局 rng 以时钟为种子，每次运行的候选序列都不同，没法在版本之间比较。
+// 基准模式对每个规模用 (seed, 规模) 派生的独立随机数流单线程生成若干个质数：mt19937 和 seed_seq 的输出由标准规定，
+// 随机起点只取决于种子，同一种子在不同版本、不同编译器下检查同一串候选，改动筛选或素性测试后可以直接对比。
+// 质数校验和用来确认两次运行找到的确实是同一批质数。
+
+struct BenchSize {
+	int size;
+	bool bits;   // true 按比特计（最高两位为1），false 按十进制位数计
+};
+
+// 升序样本的 q 分位数（最近秩）
+double percentile(const vector<double>& sorted, double q) {
+	if (sorted.empty()) return 0;
+	size_t rank = (size_t)ceil(q * sorted.size());
+	return sorted[rank ? rank - 1 : 0];
+}
+
+// 按规模依次生成 count 个质数，统计结果以 JSON 写到 out
+void run_generation_bench(uint64_t seed, const vector<BenchSize>& sizes, int count, ostream& out) {
+	out << "{\n  \"seed\": " << seed << ",\n  \"count\": " << count << ",\n  \"threads\": 1,\n  \"prime_table\": "
+		<< (hpcore::default_prime_table() ? "true" : "false") << ",\n  \"results\": [\n";
+	for (size_t k = 0; k < sizes.size(); k++) {
+		const BenchSize& bs = sizes[k];
+		BigUInt lo, hi;
+		if (bs.bits) {
+			bit_range(bs.size, lo, hi);
+		} else {
+			decimal_range(bs.size, lo, hi);
+		}
+		seed_seq seq{(uint32_t)seed, (uint32_t)(seed >> 32), (uint32_t)bs.size, (uint32_t)bs.bits};
+		mt19937 gen(seq);
+		
+		SearchStats stats;
+		search_stats = &stats;
+		vector<double> prime_ms;
+		uint64_t checksum = 0;
+		auto t0 = chrono::steady_clock::now();
+		for (int i = 0; i < count; i++) {
+			auto p0 = chrono::steady_clock::now();
+			BigUInt prime;
+			random_prime_in(lo, hi, gen, prime);
+			prime_ms.push_back(chrono::duration<double, milli>(chrono::steady_clock::now() - p0).count());
+			checksum = (checksum ^ prime.mod_small(4294967291u)) * 0x100000001B3ULL;
+		}
+		double seconds = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+		search_stats = nullptr;
+		
+		uint64_t tested = stats.test_ns.size(), candidates = stats.sieved + tested;
+		double test_total = accumulate(stats.test_ns.begin(), stats.test_ns.end(), 0.0);
+		sort(stats.test_ns.begin(), stats.test_ns.end());
+		sort(prime_ms.begin(), prime_ms.end());
+		double c = candidates ? (double)candidates : 1;
+		out << "    {\"size\": " << bs.size << ", \"unit\": \"" << (bs.bits ? "bits" : "digits") << "\""
+			<< ", \"primes\": " << count << ", \"seconds\": " << seconds
+			<< ", \"candidates\": " << candidates << ", \"candidates_per_second\": " << candidates / max(seconds, 1e-9)
+			<< ", \"sieve_rejected_fraction\": " << stats.sieved / c
+			<< ", \"test_rejected_fraction\": " << stats.rejected / c
+			<< ", \"test_calls\": " << tested
+			<< ", \"test_us\": {\"mean\": " << (tested ? test_total / tested / 1e3 : 0)
+			<< ", \"p50\": " << percentile(stats.test_ns, 0.5) / 1e3 << ", \"p99\": " << percentile(stats.test_ns, 0.99) / 1e3 << "}"
+			<< ", \"ms_per_prime\": {\"mean\": " << seconds * 1e3 / max(count, 1)
+			<< ", \"p50\": " << percentile(prime_ms, 0.5) << ", \"p99\": " << percentile(prime_ms, 0.99) << "}"
+			<< ", \"checksum\": \"" << hex << checksum << dec << "\"}"
+			<< (k + 1 < sizes.size() ? "," : "") << "\n";
+		cerr << bs.size << (bs.bits ? " 比特" : " 位") << "：" << count << " 个质数，" << seconds << " 秒" << endl;
+	}
+	out << "  ]\n}\n";
+}
+
+// ==================== 命令行批处理模式 ====================
+
+void print_batch_usage() {
+	cerr << "用法：" << endl;
+	cerr << "  prime --test <输入.txt> [--unordered] [--threads N]" << endl;
+	cerr << "                                            多线程逐行测试，输出“数 1/0”；无序模式每行前加输入序号" << endl;
+	cerr << "                                            每行也可写 2^p-1、k*2^n+1、k*2^n-1，用 Lucas-Lehmer、Proth、LLR 确定性判定" << endl;
+	cerr << "  prime --range <a> <b> [--count] [--out 文件] [--threads N]" << endl;
+	cerr << "                                            分段筛列出（或只统计）[a, b] 中的质数，b 不超过 10^16" << endl;
+	cerr << "  prime --next <n> [个数] [--threads N]     按从小到大输出大于 n 的若干个质数（默认 1 个），逐个流式输出" << endl;
+	cerr << "  prime --prev <n> [--threads N]            输出小于 n 的最大质数" << endl;
+	cerr << "  prime --provable <比特数> [个数] [--cert 文件] [--threads N]" << endl;
+	cerr << "                                            Maurer 构造可证明质数（最高两位为1），默认把 Pocklington 证书链写到标准输出；" << endl;
+	cerr << "                                            给出 --cert 时证书写入文件，标准输出只列质数" << endl;
+	cerr << "  prime --verify-cert <证书文件|->         校验证书，每份输出“质数 1/0”" << endl;
+	cerr << "  prime --tuple <样式> <a> <b> [--count] [--threads N]" << endl;
+	cerr << "                                            列出（或只统计）首项在 [a, b] 中的质数星座，每行输出首项；样式为 twin、cousin、sexy、" << endl;
+	cerr << "                                            triplet、triplet2、quadruplet、quintuplet、quintuplet2、sextuplet 或偏移列表（如 0,2,6,8）" << endl;
+	cerr << "  prime --tuple <样式> --random <位数> [个数] [--bits] [--threads N]" << endl;
+	cerr << "                                            从随机起点向上找指定位数的星座，各线程分担窗口" << endl;
+	cerr << "  prime --pi <x> [--threads N]              计算 π(x)（不超过 x 的质数个数），x 不超过 10^18" << endl;
+	cerr << "  prime --make-table <文件> [上界] [--threads N]" << endl;
+	cerr << "                                            生成上界（默认 2^32）以内的预计算素数表；命名为 primes.hppt 放在当前目录" << endl;
+	cerr << "                                            （或用环境变量 HP_PRIME_TABLE 指定）后，各模式启动时直接映射，免去现场筛选" << endl;
+	cerr << "  prime --factor <n|-> [n ...] [--threads N] 分解质因数，- 表示从标准输入逐行读取" << endl;
+	cerr << "  prime --test-bin <输入.hpbn> <输出.hpbn>   输出输入中的全部质数" << endl;
+	cerr << "  prime --gen-bin <位数> <个数> <输出.hpbn> [--bits] [--safe|--strong]" << endl;
+	cerr << "                                            多线程生成指定个数的随机质数（或安全素数、Gordon 强素数）" << endl;
+	cerr << "                                            --bits 表示位数按比特计（如 512-8192），最高两位为1" << endl;
+	cerr << "  prime --gen <位数> <个数> [--bits] [--safe|--strong]" << endl;
+	cerr << "                                            同上，按十进制每行一个输出到标准输出" << endl;
+	cerr << "  prime --bench [--seed N] [--bits 列表|--digits 列表] [--count N] [--out 文件]" << endl;
+	cerr << "                                            固定种子的生成基准（默认 256,512,1024,2048 比特各 10 个），输出 JSON：" << endl;
+	cerr << "                                            候选速率、筛掉/测试判为合数的比例、单次素性测试和每个质数耗时的均值、p50、p99" << endl;
+	cerr << "文件名写 - 表示标准输入/标准输出，可与其他工具用管道串联" << endl;
+	cerr << "64位以上的数默认用 Baillie-PSW 判定；任一模式前加 --mr-rounds N 可再追加 N 轮随机基米勒-拉宾" << endl;
+	cerr << "任一模式前加 --test-threads N 可把单个 " << PARALLEL_TEST_MIN_BITS << " 比特以上数的测试拆给 N 个线程同时算（0 表示全部核心），"
+		 << "适合少量超大数" << endl;
+	cerr << "任一模式前加 --seed N 固定随机数种子（各线程的随机数流随之固定，单线程运行时生成结果可逐个复现）" << endl;
+}
+
+int run_batch(int argc, char* argv[]) {
+	// 全局选项：--mr-rounds N 在 Baillie-PSW 之后追加 N 轮随机基米勒-拉宾；
+	// --test-threads N 把单个大数的各个基（或 Baillie-PSW 的两半）拆给 N 个线程；
+	// --seed N 固定全局随机数的种子（多线程时各线程先到先得，只有单线程运行才逐个复现）
+	while (argc > 2 && (string(argv[1]) == "--mr-rounds" || string(argv[1]) == "--test-threads" || string(argv[1]) == "--seed")) {
+		if (string(argv[1]) == "--mr-rounds") {
+			extra_mr_rounds = atoi(argv[2]);
+		} else if (string(argv[1]) == "--seed") {
+			rng.seed((uint32_t)strtoull(argv[2], nullptr, 10));
+		} else {
+			test_threads = worker_count(atoi(argv[2]));
+		}
+		argc -= 2;
+		argv += 2;
+		if (argc < 2) {
+			print_batch_usage();
+			return 1;
+		}
+	}
+	string mode = argv[1];
+	try {
+		if (mode == "--test" && argc >= 3) {
+			bool ordered = true;
+			int threads = 0;
+			for (int i = 3; i < argc; i++) {
+				string opt = argv[i];
+				if (opt == "--unordered") {
+					ordered = false;
+				} else if (opt == "--threads" && i + 1 < argc) {
+					threads = stoi(argv[++i]);
+				} else {
+					print_batch_usage();
+					return 1;
+				}
+			}
+			string path = argv[2];
+			if (path == "-") {
+				batch_primality_test(cin, cout, ordered, threads);
+			} else {
+				ifstream file(path);
+				if (!file) {
+					cerr << "无法打开文件：" << path << endl;
+					return 1;
+				}
+				batch_primality_test(file, cout, ordered, threads);
+			}
+			return 0;
+		}
+		if (mode == "--range" && argc >= 4) {
+			uint64_t a = stoull(argv[2]), b = stoull(argv[3]);
+			bool count_only = false;
+			string out_path = "-";
+			int threads = 0;
+			for (int i = 4; i < argc; i++) {
+				string opt = argv[i];
+				if (opt == "--count") {
+					count_only = true;
+				} else if (opt == "--out" && i + 1 < argc) {
+					out_path = argv[++i];
+				} else if (opt == "--threads" && i + 1 < argc) {
+					threads = stoi(argv[++i]);
+				} else {
+					print_batch_usage();
+					return 1;
+				}
+			}
+			auto t0 = chrono::steady_clock::now();
+			uint64_t count;
+			if (count_only) {
+				count = sieve_range(a, b, nullptr, threads);
+				cout << count << endl;
+			} else if (out_path == "-") {
+				count = sieve_range(a, b, &cout, threads);
+			} else {
+				ofstream file(out_path, ios::binary);
+				if (!file) {
+					cerr << "无法写入文件：" << out_path << endl;
+					return 1;
+				}
+				count = sieve_range(a, b, &file, threads);
+			}
+			cerr << "[" << a << ", " << b << "] 中共 " << count << " 个质数，用时 "
+				 << chrono::duration<double>(chrono::steady_clock::now() - t0).count() << " 秒" << endl;
+			return 0;
+		}
+		if (mode == "--pi" && argc >= 3) {
+			uint64_t x = stoull(argv[2]);
+			int threads = 0;
+			for (int i = 3; i < argc; i++) {
+				string opt = argv[i];
+				if (opt == "--threads" && i + 1 < argc) {
+					threads = stoi(argv[++i]);
+				} else {
+					print_batch_usage();
+					return 1;
+				}
+			}
+			auto t0 = chrono::steady_clock::now();
+			uint64_t count = prime_pi(x, threads);
+			cout << count << endl;
+			cerr << "π(" << x << ") = " << count << "，用时 "
+				 << chrono::duration<double>(chrono::steady_clock::now() - t0).count() << " 秒" << endl;
+			return 0;
+		}
+		if (mode == "--make-table" && argc >= 3) {
+			string path = argv[2];
+			uint64_t limit = PRIME_TABLE_DEFAULT_LIMIT;
+			int threads = 0;
+			for (int i = 3; i < argc; i++) {
+				string opt = argv[i];
+				if (opt == "--threads" && i + 1 < argc) {
+					threads = stoi(argv[++i]);
+				} else if (i == 3 && !opt.empty() && isdigit((unsigned char)opt[0])) {
+					limit = stoull(opt);
+				} else {
+					print_batch_usage();
+					return 1;
+				}
+			}
+			auto t0 = chrono::steady_clock::now();
+			uint64_t count = make_prime_table(path, limit, threads);
+			cerr << "素数表已写入 " << path << "（" << count << " 个质数），用时 "
+				 << chrono::duration<double>(chrono::steady_clock::now() - t0).count() << " 秒" << endl;
+			return 0;
+		}
+		if (mode == "--bench") {
+			uint64_t seed = 20240601;
+			int count = 10;
+			string out_path;
+			vector<BenchSize> sizes;
+			for (int i = 2; i < argc; i++) {
+				string opt = argv[i];
+				if (opt == "--seed" && i + 1 < argc) {
+					seed = stoull(argv[++i]);
+				} else if (opt == "--count" && i + 1 < argc) {
+					count = stoi(argv[++i]);
+				} else if (opt == "--out" && i + 1 < argc) {
+					out_path = argv[++i];
+				} else if ((opt == "--bits" || opt == "--digits") && i + 1 < argc) {
+					string list = argv[++i];
+					for (size_t pos = 0; pos < list.size();) {
+						size_t comma = min(list.find(',', pos), list.size());
+						int size = stoi(list.substr(pos, comma - pos));
+						if (size < (opt == "--bits" ? 3 : 2)) throw invalid_argument("规模太小：" + to_string(size));
+						sizes.push_back({size, opt == "--bits"});
+						pos = comma + 1;
+					}
+				} else {
+					print_batch_usage();
+					return 1;
+				}
+			}
+			if (sizes.empty()) sizes = {{256, true}, {512, true}, {1024, true}, {2048, true}};
+			if (out_path.empty() || out_path == "-") {
+				run_generation_bench(seed, sizes, count, cout);
+			} else {
+				ofstream out(out_path);
+				if (!out) throw runtime_error("无法写入文件：" + out_path);
+				run_generation_bench(seed, sizes, count, out);
+			}
+			return 0;
+		}
+		if (mode == "--tuple" && argc >= 5) {
+			Constellation pattern = make_constellation(argv[2]);
+			bool random_mode = string(argv[3]) == "--random";
+			bool count_only = false, by_bits = false;
+			long long count = 1;
+			int threads = 0;
+			int first_opt = 5;
+			if (random_mode && argc >= 6 && isdigit((unsigned char)argv[5][0])) {
+				count = stoll(argv[5]);
+				first_opt = 6;
+			}
+			for (int i = first_opt; i < argc; i++) {
+				string opt = argv[i];
+				if (opt == "--threads" && i + 1 < argc) {
+					threads = stoi(argv[++i]);
+				} else if (opt == "--count" && !random_mode) {
+					count_only = true;
+				} else if (opt == "--bits" && random_mode) {
+					by_bits = true;
+				} else {
+					print_batch_usage();
+					return 1;
+				}
+			}
+			auto t0 = chrono::steady_clock::now();
+			long long found = 0;
+			if (random_mode) {
+				int size = stoi(argv[4]);
+				if (size < (by_bits ? 3 : 2) || count < 0) {
+					cerr << "位数和个数必须为正数！" << endl;
+					return 1;
+				}
+				BigUInt lo, hi, n;
+				if (by_bits) {
+					bit_range(size, lo, hi);
+				} else {
+					decimal_range(size, lo, hi);
+				}
+				for (; found < count; found++) {
+					if (!random_constellation(pattern, lo, hi, rng, n, threads)) {
+						cerr << "该位数范围内找不到这种星座" << endl;
+						return 1;
+					}
+					cout << n.to_string() << '\n';
+				}
+			} else {
+				BigUInt a(argv[3]), b(argv[4]);
+				string buf;
+				function<void(const BigUInt&)> sink;
+				if (!count_only) {
+					sink = [&](const BigUInt& n) {
+						buf += n.to_string();
+						buf += '\n';
+						if (buf.size() >= (1 << 16)) {
+							cout << buf;
+							buf.clear();
+						}
+					};
+				}
+				found = constellations_in(pattern, a, b, sink, threads);
+				cout << buf;
+				if (count_only) cout << found << '\n';
+			}
+			cout.flush();
+			cerr << "共 " << found << " 个星座，用时 " << chrono::duration<double>(chrono::steady_clock::now() - t0).count() << " 秒" << endl;
+			return 0;
+		}
+		if ((mode == "--next" || mode == "--prev") && argc >= 3) {
+			string text = argv[2];
+			long long count = 1;
+			int threads = 0;
+			for (int i = 3; i < argc; i++) {
+				string opt = argv[i];
+				if (opt == "--threads" && i + 1 < argc) {
+					threads = stoi(argv[++i]);
+				} else if (mode == "--next" && i == 3 && all_of(opt.begin(), opt.end(), ::isdigit)) {
+					count = stoll(opt);
+				} else {
+					print_batch_usage();
+					return 1;
+				}
+			}
+			if (text.empty() || !all_of(text.begin(), text.end(), ::isdigit)) {
+				cerr << "输入无效：" << text << endl;
+				return 1;
+			}
+			BigUInt n(text);
+			if (mode == "--prev") {
+				cout << prev_prime(n, threads).to_string() << endl;
+				return 0;
+			}
+			// 逐个写出并刷新，方便下游边读边用
+			primes_after(n, count, [](const BigUInt& p) { cout << p.to_string() << '\n' << flush; }, threads);
+			return 0;
+		}
+		if (mode == "--provable" && argc >= 3) {
+			int bits = stoi(argv[2]);
+			long long count = 1;
+			string cert_path;
+			int threads = 0;
+			for (int i = 3; i < argc; i++) {
+				string opt = argv[i];
+				if (opt == "--cert" && i + 1 < argc) {
+					cert_path = argv[++i];
+				} else if (opt == "--threads" && i + 1 < argc) {
+					threads = stoi(argv[++i]);
+				} else if (i == 3 && all_of(opt.begin(), opt.end(), ::isdigit)) {
+					count = stoll(opt);
+				} else {
+					print_batch_usage();
+					return 1;
+				}
+			}
+			ofstream cert_file;
+			if (!cert_path.empty()) {
+				cert_file.open(cert_path);
+				if (!cert_file) {
+					cerr << "无法写入文件：" << cert_path << endl;
+					return 1;
+				}
+			}
+			auto t0 = chrono::steady_clock::now();
+			generate_provable_primes(bits, count, [&](const PrimeCertificate& cert) {
+				if (cert_path.empty()) {
+					cout << cert.to_string() << flush;
+				} else {
+					cert_file << cert.to_string();
+					cout << cert.prime.to_string() << '\n' << flush;
+				}
+			}, threads);
+			cerr << "生成 " << count << " 个 " << bits << " 比特可证明质数，用时 "
+				 << chrono::duration<double>(chrono::steady_clock::now() - t0).count() << " 秒" << endl;
+			return 0;
+		}
+		if (mode == "--verify-cert" && argc == 3) {
+			string path = argv[2];
+			ifstream file;
+			if (path != "-") {
+				file.open(path);
+				if (!file) {
+					cerr << "无法打开文件：" << path << endl;
+					return 1;
+				}
+			}
+			long long total = 0, failed = 0;
+			auto t0 = chrono::steady_clock::now();
+			for_each_certificate(path == "-" ? cin : file, [&](const PrimeCertificate& cert) {
+				string error;
+				bool ok = verify_certificate(cert, error);
+				total++;
+				if (!ok) {
+					failed++;
+					cerr << cert.prime.to_string() << "：" << error << endl;
+				}
+				cout << cert.prime.to_string() << ' ' << (ok ? 1 : 0) << '\n';
+			});
+			cout.flush();
+			cerr << "校验 " << total << " 份证书，失败 " << failed << " 份，用时 "
+				 << chrono::duration<double>(chrono::steady_clock::now() - t0).count() << " 秒" << endl;
+			return failed ? 1 : 0;
+		}
+		if (mode == "--factor" && argc >= 3) {
+			int threads = 0;
+			vector<string> inputs;
+			for (int i = 2; i < argc; i++) {
+				string arg = argv[i];
+				if (arg == "--threads" && i + 1 < argc) {
+					threads = stoi(argv[++i]);
+				} else if (arg == "-") {
+					for (string line; getline(cin, line);) {
+						line.erase(remove_if(line.begin(), line.end(), ::isspace), line.end());
+						if (!line.empty()) inputs.push_back(line);
+					}
+				} else {
+					inputs.push_back(arg);
+				}
+			}
+			for (const string& text : inputs) {
+				if (!all_of(text.begin(), text.end(), ::isdigit)) {
+					cerr << "输入无效：" << text << endl;
+					continue;
+				}
+				BigUInt n(text);
+				if (n < BigUInt(2)) {
+					cout << n.to_string() << " = " << n.to_string() << endl;
+					continue;
+				}
+				cout << n.to_string() << " = " << format_factorization(factorize(n, threads)) << endl;
+			}
+			return 0;
+		}
+		if (mode == "--test-bin" && argc == 4) {
+			hpcore::HpbnOutput output(argv[3]);
+			hpcore::HpbnWriter writer(output.stream());
+			long long total = 0;
+			hpcore::hpbn_for_each(argv[2], [&](const hpcore::HpbnView& rec) {
+				total++;
+				// 分数和负数都不是质数；偶数直接在映射区上排除，只有奇数才复制出来测试
+				if (rec.kind != hpcore::HPBN_INTEGER || rec.sign < 0) return;
+				if (rec.num_is_even()) {
+					if (rec.num_value() == BigUInt(2)) writer.write_integer(BigUInt(2));
+					return;
+				}
+				BigUInt n = rec.num_value();
+				if (is_prime(n)) writer.write_integer(n);
+			});
+			writer.finish();
+			cerr << "共读取 " << total << " 个数，其中质数 " << writer.records_written() << " 个" << endl;
+			return 0;
+		}
+		if ((mode == "--gen-bin" && argc >= 5) || (mode == "--gen" && argc >= 4)) {
+			int digits = stoi(argv[2]);
+			long long count = stoll(argv[3]);
+			int first_opt = mode == "--gen" ? 4 : 5;
+			PrimeKind kind = PRIME_PLAIN;
+			bool by_bits = false;
+			for (int i = first_opt; i < argc; i++) {
+				string opt = argv[i];
+				if (opt == "--bits") {
+					by_bits = true;
+				} else if (opt == "--safe") {
+					kind = PRIME_SAFE;
+				} else if (opt == "--strong") {
+					kind = PRIME_STRONG;
+				} else {
+					print_batch_usage();
+					return 1;
+				}
+			}
+			if (digits < 1 || count < 0) {
+				cerr << "位数和个数必须为正数！" << endl;
+				return 1;
+			}
+			auto generate = [&](const function<void(const BigUInt&)>& sink) {
+				if (by_bits) {
+					generate_primes_by_bits(kind, digits, count, sink);
+				} else if (kind == PRIME_PLAIN) {
+					generate_random_primes(digits, count, sink);
+				} else {
+					generate_special_primes(kind, digits, count, sink);
+				}
+			};
+			if (mode == "--gen") {
+				generate([](const BigUInt& p) { cout << p.to_string() << '\n'; });
+				cout.flush();
+				return 0;
+			}
+			hpcore::HpbnOutput output(argv[4]);
+			hpcore::HpbnWriter writer(output.stream());
+			generate([&](const BigUInt& p) { writer.write_integer(p); });
+			writer.finish();
+			return 0;
+		}
+	} catch (const exception& e) {
+		cerr << "错误：" << e.what() << endl;
+		return 1;
+	}
+	print_batch_usage();
+	return 1;
+}
+
+// ==================== 主函数 ====================
+
+// 交互模式的长度上限：判断和生成都可到 8192 比特左右（十进制约2467位）
+const size_t MAX_INTERACTIVE_DIGITS = 2500;
+const int MAX_INTERACTIVE_BITS = 8192;
+
+int main(int argc, char* argv[]) {
+	if (argc > 1) return run_batch(argc, argv);
+	
+	int choice;
+	cout << "选择操作：" << endl;
+	cout << "1. 判断输入的数是否为质数" << endl;
+	cout << "2. 随机生成一个质数" << endl;
+	cout << "3. 分解质因数" << endl;
+	cout << "4. 按比特数随机生成一个质数（最高两位为1，用于 RSA）" << endl;
+	cout << "请输入选择 (1-4): ";
+	cin >> choice;
+	
+	if (choice == 1) {
+		// 判断输入的数是否为质数
+		string n;
+		cout << "请输入一个大整数（不超过" << MAX_INTERACTIVE_DIGITS << "位），或 2^p-1、k*2^n+1、k*2^n-1 形式的表达式: ";
+		cin >> n;
+		
+		// 移除可能的空格或换行
+		n.erase(remove_if(n.begin(), n.end(), ::isspace), n.end());
+		
+		SpecialForm form;
+		if (parse_special_form(n, form)) {
+			cout << "测试中（" << (form.c > 0 ? "Proth" : form.k == 1 ? "Lucas-Lehmer" : "LLR") << "），请稍候..." << endl;
+			cout << form.to_string() << (special_form_is_prime(form) ? " 是质数" : " 不是质数") << endl;
+			return 0;
+		}
+		
+		// 验证输入
+		if (n.length() > MAX_INTERACTIVE_DIGITS || !all_of(n.begin(), n.end(), ::isdigit)) {
+			cout << "输入无效！" << endl;
+			return 1;
+		}
+		
+		// 移除前导零
+		n.erase(0, n.find_first_not_of('0'));
+		if (n.empty()) n = "0";
+		
+		// 检查是否为质数：只测一个数，各个基拆给全部核心同时算
+		test_threads = worker_count(0);
+		cout << "测试中，请稍候..." << endl;
+		if (is_prime(BigUInt(n))) {
+			cout << n << " 是质数" << endl;
+		} else {
+			cout << n << " 不是质数" << endl;
+		}
+	} else if (choice == 3) {
+		// 分解质因数
+		string n;
+		cout << "请输入一个大整数（不超过100位）: ";
+		cin >> n;
+		
+		if (n.length() > 100 || !all_of(n.begin(), n.end(), ::isdigit)) {
+			cout << "输入无效！" << endl;
+			return 1;
+		}
+		n.erase(0, n.find_first_not_of('0'));
+		if (n.empty()) n = "0";
+		
+		BigUInt value(n);
+		if (value < BigUInt(2)) {
+			cout << n << " 没有质因数" << endl;
+			return 0;
+		}
+		cout << "分解中，较大的数可能需要较长时间..." << endl;
+		cout << n << " = " << format_factorization(factorize(value)) << endl;
+	} else if (choice == 2) {
+		// 随机生成质数
+		int digits;
+		cout << "请输入要生成的质数的位数 (1-" << MAX_INTERACTIVE_DIGITS << "): ";
+		cin >> digits;
+		
+		if (digits < 1 || digits > (int)MAX_INTERACTIVE_DIGITS) {
+			cout << "位数必须在1到" << MAX_INTERACTIVE_DIGITS << "之间！" << endl;
+			return 1;
+		}
+		
+		cout << "正在生成 " << digits << " 位的随机质数..." << endl;
+		cout << "这可能需要一些时间，请耐心等待..." << endl;
+		
+		string prime = generate_random_primes(digits, 1)[0].to_string();
+		
+		cout << "\n生成的质数为：" << endl;
+		cout << prime << endl;
+		
+		// 验证一下（可选）
+		cout << "\n验证中..." << endl;
+		if (is_prime(BigUInt(prime))) {
+			cout << "验证通过：这是一个质数" << endl;
+		} else {
+			cout << "警告：生成的数可能不是质数！" << endl;
+		}
+		cout << "位数：" << prime.length() << endl;
+	} else if (choice == 4) {
+		// 按比特数生成质数
+		int bits;
+		cout << "请输入要生成的质数的比特数 (" << MIN_PRIME_BITS << "-" << MAX_INTERACTIVE_BITS << "，常用 1024、2048、4096): ";
+		cin >> bits;
+		
+		if (bits < MIN_PRIME_BITS || bits > MAX_INTERACTIVE_BITS) {
+			cout << "比特数必须在" << MIN_PRIME_BITS << "到" << MAX_INTERACTIVE_BITS << "之间！" << endl;
+			return 1;
+		}
+		
+		cout << "正在生成 " << bits << " 比特的随机质数..." << endl;
+		BigUInt prime;
+		generate_primes_by_bits(PRIME_PLAIN, bits, 1, [&](const BigUInt& p) { prime = p; });
+		
+		cout << "\n生成的质数为：" << endl;
+		cout << prime.to_string() << endl;
+		cout << "比特数：" << prime.bit_length() << "，十进制位数：" << prime.to_string().length() << endl;
+	} else {
+		cout << "无效的选择！" << endl;
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,226 @@
+// 预计算小素数表（.hppt）：mod 30 轮位图加上试除用的多模数余数器分组。生成一次之后各工具只读映射，
+// 启动时不必再筛，也不必逐组求逆；多个进程映射同一个文件时共享页缓存。文件不存在时由调用方退回现场筛选。
+//
+// 文件头（64字节，所有整数字段均为小端）：
+//   magic "HPPT" | u16 版本号(=1) | u16 文件头长度(=64)
+//   u64 limit         位图覆盖 [0, limit)，为 30 的倍数
+//   u64 prime_count   [0, limit) 中的质数个数（含 2、3、5）
+//   u64 moduli_limit  余数器收录 [3, moduli_limit) 中的全部奇素数
+//   u64 moduli_count  余数器中的素数个数
+//   u64 group_count   余数器的实际分组数
+//   u64 保留 ×2
+// 之后各段依次排列，每段起点按8字节对齐：
+//   u32 moduli[moduli_count]       奇素数，从小到大
+//   u64 first[group_count + 1]     第 g 组的素数下标为 [first[g], first[g+1])
+//   u64 d[padded]、u64 v[padded]   各组规格化后的乘积及其预求逆，padded 为 group_count 补齐到4的倍数
+//   u8  bitmap[limit / 30]         第 i 字节第 j 位置位 <=> 30i + {1,7,11,13,17,19,23,29}[j] 是质数
+#ifndef HP_PRIMETABLE_H
+#define HP_PRIMETABLE_H
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <stdexcept>
+#include "bigint.h"
+#include "bigbin.h"
+
+namespace hpcore {
+
+const char PRIME_TABLE_MAGIC[4] = {'H', 'P', 'P', 'T'};
+const uint16_t PRIME_TABLE_VERSION = 1;
+const uint16_t PRIME_TABLE_HEADER_SIZE = 64;
+// 默认文件名（当前目录下），环境变量 HP_PRIME_TABLE 可指定其他路径
+const char* const PRIME_TABLE_DEFAULT_PATH = "primes.hppt";
+
+const uint32_t PRIME_TABLE_WHEEL[8] = {1, 7, 11, 13, 17, 19, 23, 29};
+
+// 余数 r（mod 30）在位图字节中对应的位，与 30 不互素时为 0
+inline uint8_t prime_table_wheel_bit(uint64_t r) {
+	static const uint8_t bits[30] = {
+		0, 1, 0, 0, 0, 0, 0, 2, 0, 0, 0, 4, 0, 8, 0, 0, 0, 16, 0, 32, 0, 0, 0, 64, 0, 0, 0, 0, 0, 128
+	};
+	return bits[r];
+}
+
+inline size_t prime_table_align8(size_t n) { return (n + 7) / 8 * 8; }
+
+inline uint64_t prime_table_get_u64(const unsigned char* p) {
+	uint64_t v;
+	memcpy(&v, p, 8);
+	return v;
+}
+
+class PrimeTable {
+private:
+	MappedFile file;
+	uint64_t limit_ = 0, prime_count_ = 0, moduli_limit_ = 0, moduli_count_ = 0, group_count_ = 0;
+	const uint32_t* moduli_ = nullptr;
+	const uint64_t* first_ = nullptr;
+	const limb_t* d_ = nullptr;
+	const limb_t* v_ = nullptr;
+	const uint8_t* bitmap_ = nullptr;
+
+public:
+	// 映射并校验文件，格式不符时抛出 runtime_error
+	explicit PrimeTable(const std::string& path) : file(path) {
+		const unsigned char* p = file.data();
+		size_t length = file.size();
+		if (length < PRIME_TABLE_HEADER_SIZE || memcmp(p, PRIME_TABLE_MAGIC, 4) != 0) {
+			throw std::runtime_error("不是素数表文件：" + path);
+		}
+		uint16_t version, header;
+		memcpy(&version, p + 4, 2);
+		memcpy(&header, p + 6, 2);
+		if (version != PRIME_TABLE_VERSION || header != PRIME_TABLE_HEADER_SIZE) {
+			throw std::runtime_error("不支持的素数表版本：" + path);
+		}
+		limit_ = prime_table_get_u64(p + 8);
+		prime_count_ = prime_table_get_u64(p + 16);
+		moduli_limit_ = prime_table_get_u64(p + 24);
+		moduli_count_ = prime_table_get_u64(p + 32);
+		group_count_ = prime_table_get_u64(p + 40);
+		if (limit_ % 30 || moduli_count_ > moduli_limit_ || group_count_ > moduli_count_ || moduli_limit_ > UINT32_MAX) {
+			throw std::runtime_error("素数表文件头损坏：" + path);
+		}
+		size_t padded = (group_count_ + 3) / 4 * 4;
+		size_t moduli_at = PRIME_TABLE_HEADER_SIZE;
+		size_t first_at = moduli_at + prime_table_align8(moduli_count_ * 4);
+		size_t d_at = first_at + (group_count_ + 1) * 8;
+		size_t v_at = d_at + padded * 8;
+		size_t bitmap_at = v_at + padded * 8;
+		if (length != bitmap_at + limit_ / 30) throw std::runtime_error("素数表文件长度不符：" + path);
+		// 映射区起点按页对齐，各段起点都是8的倍数，可以直接按数组访问
+		moduli_ = (const uint32_t*)(p + moduli_at);
+		first_ = (const uint64_t*)(p + first_at);
+		d_ = (const limb_t*)(p + d_at);
+		v_ = (const limb_t*)(p + v_at);
+		bitmap_ = p + bitmap_at;
+		if (first_[0] != 0 || first_[group_count_] != moduli_count_) throw std::runtime_error("素数表分组损坏：" + path);
+	}
+
+	PrimeTable(const PrimeTable&) = delete;
+	PrimeTable& operator=(const PrimeTable&) = delete;
+
+	uint64_t limit() const { return limit_; }
+	uint64_t prime_count() const { return prime_count_; }
+	uint64_t moduli_limit() const { return moduli_limit_; }
+	const uint8_t* bitmap() const { return bitmap_; }
+
+	// n < limit()
+	bool is_prime(uint64_t n) const {
+		if (n < 7) return n == 2 || n == 3 || n == 5;
+		uint8_t bit = prime_table_wheel_bit(n % 30);
+		return bit && (bitmap_[n / 30] & bit);
+	}
+
+	// 依次对 [lo, hi) 与 [0, limit()) 交集中的每个质数调用 f
+	template <class F>
+	void for_each_prime(uint64_t lo, uint64_t hi, F f) const {
+		if (hi > limit_) hi = limit_;
+		for (uint64_t p : {2, 3, 5}) {
+			if (p >= lo && p < hi) f(p);
+		}
+		if (lo >= hi) return;
+		for (uint64_t i = lo / 30; i * 30 < hi; i++) {
+			for (uint8_t bits = bitmap_[i]; bits; bits &= bits - 1) {
+				uint64_t v = 30 * i + PRIME_TABLE_WHEEL[__builtin_ctz(bits)];
+				if (v >= lo && v < hi) f(v);
+			}
+		}
+	}
+
+	// [3, bound) 中的奇素数（bound 不超过 moduli_limit() 时直接取余数器的素数表）
+	std::vector<uint32_t> odd_primes_below(uint64_t bound) const {
+		std::vector<uint32_t> result;
+		if (bound <= moduli_limit_) {
+			const uint32_t* end = std::lower_bound(moduli_, moduli_ + moduli_count_, bound);
+			return std::vector<uint32_t>(moduli_, end);
+		}
+		for_each_prime(3, bound, [&](uint64_t p) { result.push_back((uint32_t)p); });
+		return result;
+	}
+
+	// 用预计算的分组直接建余数器
+	SmallModuli moduli() const {
+		size_t padded = (group_count_ + 3) / 4 * 4;
+		return SmallModuli(std::vector<uint32_t>(moduli_, moduli_ + moduli_count_), std::vector<limb_t>(d_, d_ + padded),
+						   std::vector<limb_t>(v_, v_ + padded), std::vector<size_t>(first_, first_ + group_count_ + 1));
+	}
+};
+
+// 写出素数表：构造时写文件头和余数器分组，之后按顺序追加位图，finish 时回填质数个数
+class PrimeTableWriter {
+private:
+	std::ostream& out;
+	uint64_t limit;
+	uint64_t bitmap_written = 0;
+
+	void put_u64(uint64_t v) { out.write((const char*)&v, 8); }
+	void pad8(size_t n) {
+		static const char zeros[8] = {0};
+		out.write(zeros, prime_table_align8(n) - n);
+	}
+
+public:
+	// out 须可回写（文件流）；moduli 收录 [3, moduli_limit) 中的全部奇素数
+	PrimeTableWriter(std::ostream& os, uint64_t table_limit, uint64_t moduli_limit, const SmallModuli& moduli)
+		: out(os), limit(table_limit) {
+		if (limit % 30) throw std::invalid_argument("素数表上界必须是 30 的倍数");
+		const std::vector<size_t>& first = moduli.group_starts();
+		out.write(PRIME_TABLE_MAGIC, 4);
+		out.write((const char*)&PRIME_TABLE_VERSION, 2);
+		out.write((const char*)&PRIME_TABLE_HEADER_SIZE, 2);
+		put_u64(limit);
+		put_u64(0);   // 质数个数，finish 时回填
+		put_u64(moduli_limit);
+		put_u64(moduli.size());
+		put_u64(first.size() - 1);
+		put_u64(0);
+		put_u64(0);
+		out.write((const char*)moduli.moduli().data(), moduli.size() * 4);
+		pad8(moduli.size() * 4);
+		for (size_t f : first) put_u64(f);
+		for (limb_t d : moduli.group_divisors()) put_u64(d);
+		for (limb_t v : moduli.group_reciprocals()) put_u64(v);
+	}
+
+	void write_bitmap(const uint8_t* bytes, size_t n) {
+		out.write((const char*)bytes, n);
+		bitmap_written += n;
+	}
+
+	void finish(uint64_t prime_count) {
+		if (bitmap_written != limit / 30) throw std::logic_error("素数表位图长度不符");
+		out.seekp(16);
+		put_u64(prime_count);
+		out.seekp(0, std::ios::end);
+		out.flush();
+		if (!out) throw std::runtime_error("写入素数表失败");
+	}
+};
+
+// 默认素数表：HP_PRIME_TABLE 指定的路径，否则当前目录下的 primes.hppt；
+// 首次调用时映射，文件不存在时返回 nullptr（损坏时另在标准错误上提示一次）
+inline const PrimeTable* default_prime_table() {
+	static const PrimeTable* table = [] () -> const PrimeTable* {
+		const char* env = getenv("HP_PRIME_TABLE");
+		std::string path = env && *env ? env : PRIME_TABLE_DEFAULT_PATH;
+		FILE* probe = fopen(path.c_str(), "rb");
+		if (!probe) return nullptr;
+		fclose(probe);
+		try {
+			return new PrimeTable(path);
+		} catch (const std::exception& e) {
+			std::cerr << "忽略素数表：" << e.what() << std::endl;
+			return nullptr;
+		}
+	}();
+	return table;
+}
+
+}  // namespace hpcore
+
+#endif
@@ -0,0 +1,218 @@
+// 热点插桩计数器（编译期开关）
+// 用法：g++ -DHP_PROFILE prime.cpp -o prime.exe
+// 启用后统计每个内核的调用次数、操作数规模直方图（按64位limb数）、内存分配次数和累计周期数，
+// 程序退出时或收到信号（POSIX 为 SIGUSR1，Windows 为 Ctrl+Break）时输出报告到 stderr。
+// 未定义 HP_PROFILE 时所有宏都展开为空语句，参数也不会被求值，发布版零开销。
+#ifndef HP_PROFILER_H
+#define HP_PROFILER_H
+
+#include <stddef.h>
+
+// 十进制位数换算为64位limb数（一个limb约19.27位十进制数）
+#define PROF_LIMBS_DIGITS(d) (((size_t)(d) + 18) / 19)
+
+#ifdef HP_PROFILE
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <csignal>
+#include <new>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// 直方图桶：第k个桶统计 limb 数落在 (2^(k-1), 2^k] 的调用，桶0统计0~1个limb
+const int PROF_HIST_BUCKETS = 22;
+const int PROF_MAX_COUNTERS = 64;
+
+struct ProfCounter;
+
+// 全局计数器注册表
+struct ProfRegistry {
+	std::atomic<int> count{0};
+	ProfCounter* counters[PROF_MAX_COUNTERS] = {};
+};
+
+inline ProfRegistry& prof_registry() {
+	static ProfRegistry reg;
+	return reg;
+}
+
+// 读取时间戳计数器，不支持时退化为纳秒
+inline unsigned long long prof_cycles() {
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+	return __rdtsc();
+#else
+	return (unsigned long long)std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+}
+
+void prof_report(FILE* out);
+
+struct ProfCounter {
+	const char* name;
+	int id;
+	std::atomic<unsigned long long> calls{0};
+	std::atomic<unsigned long long> cycles{0};
+	std::atomic<unsigned long long> allocs{0};
+	std::atomic<unsigned long long> alloc_bytes{0};
+	std::atomic<unsigned long long> hist[PROF_HIST_BUCKETS];
+
+	explicit ProfCounter(const char* n);
+};
+
+// 当前线程最内层的计数器（分配次数记在它上面）及每个计数器的递归深度
+inline ProfCounter*& prof_current() {
+	thread_local ProfCounter* cur = nullptr;
+	return cur;
+}
+
+inline int* prof_depth() {
+	thread_local int depth[PROF_MAX_COUNTERS] = {};
+	return depth;
+}
+
+inline void prof_signal_handler(int sig) {
+	// 诊断用途：fprintf 并非严格的异步信号安全函数，但对插桩版本足够
+	prof_report(stderr);
+	signal(sig, prof_signal_handler);
+}
+
+inline void prof_report_at_exit() {
+	prof_report(stderr);
+}
+
+inline ProfCounter::ProfCounter(const char* n) : name(n) {
+	for (auto& h : hist) h.store(0, std::memory_order_relaxed);
+	ProfRegistry& reg = prof_registry();
+	id = reg.count.fetch_add(1);
+	if (id < PROF_MAX_COUNTERS) {
+		reg.counters[id] = this;
+	} else {
+		id = -1;
+	}
+	// 第一个计数器注册时安装退出钩子和信号处理
+	if (id == 0) {
+		atexit(prof_report_at_exit);
+#ifdef _WIN32
+		signal(SIGBREAK, prof_signal_handler);
+#else
+		signal(SIGUSR1, prof_signal_handler);
+#endif
+	}
+}
+
+inline int prof_bucket(size_t limbs) {
+	int b = 0;
+	size_t cap = 1;
+	while (cap < limbs && b < PROF_HIST_BUCKETS - 1) {
+		cap <<= 1;
+		++b;
+	}
+	return b;
+}
+
+// 作用域计时器：构造时计数，析构时累加周期（递归调用只计最外层的周期）
+class ProfScope {
+private:
+	ProfCounter& ctr;
+	ProfCounter* prev;
+	unsigned long long start;
+	bool outermost;
+
+public:
+	ProfScope(ProfCounter& c, size_t limbs) : ctr(c), prev(prof_current()) {
+		ctr.calls.fetch_add(1, std::memory_order_relaxed);
+		ctr.hist[prof_bucket(limbs)].fetch_add(1, std::memory_order_relaxed);
+		outermost = ctr.id < 0 || prof_depth()[ctr.id]++ == 0;
+		prof_current() = &ctr;
+		start = prof_cycles();
+	}
+
+	~ProfScope() {
+		unsigned long long elapsed = prof_cycles() - start;
+		if (ctr.id >= 0) --prof_depth()[ctr.id];
+		if (outermost) ctr.cycles.fetch_add(elapsed, std::memory_order_relaxed);
+		prof_current() = prev;
+	}
+
+	ProfScope(const ProfScope&) = delete;
+	ProfScope& operator=(const ProfScope&) = delete;
+};
+
+inline void prof_report(FILE* out) {
+	ProfRegistry& reg = prof_registry();
+	int n = reg.count.load();
+	if (n > PROF_MAX_COUNTERS) n = PROF_MAX_COUNTERS;
+	fprintf(out, "\n==================== 性能插桩报告 ====================\n");
+	fprintf(out, "%-16s %12s %16s %14s %12s %14s\n", "内核", "调用次数", "累计周期", "周期/调用", "分配次数", "分配字节");
+	for (int i = 0; i < n; ++i) {
+		ProfCounter* c = reg.counters[i];
+		if (!c) continue;
+		unsigned long long calls = c->calls.load();
+		unsigned long long cycles = c->cycles.load();
+		fprintf(out, "%-16s %12llu %16llu %14llu %12llu %14llu\n", c->name, calls, cycles,
+			calls ? cycles / calls : 0ULL, c->allocs.load(), c->alloc_bytes.load());
+	}
+	fprintf(out, "\n操作数规模直方图（limb数 <= 上界: 调用次数）\n");
+	for (int i = 0; i < n; ++i) {
+		ProfCounter* c = reg.counters[i];
+		if (!c || c->calls.load() == 0) continue;
+		fprintf(out, "%-16s", c->name);
+		for (int b = 0; b < PROF_HIST_BUCKETS; ++b) {
+			unsigned long long h = c->hist[b].load();
+			if (h) fprintf(out, " %llu:%llu", 1ULL << b, h);
+		}
+		fprintf(out, "\n");
+	}
+	fflush(out);
+}
+
+// 统计全局内存分配（每个工具都是单个翻译单元，在此处替换全局 operator new 是安全的）
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+inline void prof_count_alloc(size_t size) {
+	ProfCounter* c = prof_current();
+	if (c) {
+		c->allocs.fetch_add(1, std::memory_order_relaxed);
+		c->alloc_bytes.fetch_add(size, std::memory_order_relaxed);
+	}
+}
+
+void* operator new(size_t size) {
+	prof_count_alloc(size);
+	if (void* p = malloc(size ? size : 1)) return p;
+	throw std::bad_alloc();
+}
+
+void* operator new[](size_t size) {
+	prof_count_alloc(size);
+	if (void* p = malloc(size ? size : 1)) return p;
+	throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
+
+#define PROF_CONCAT_INNER(a, b) a##b
+#define PROF_CONCAT(a, b) PROF_CONCAT_INNER(a, b)
+
+// 在函数开头放置：PROF_SCOPE("mul", 操作数limb数)
+#define PROF_SCOPE(name, limbs) \
+	static ProfCounter PROF_CONCAT(prof_ctr_, __LINE__)(name); \
+	ProfScope PROF_CONCAT(prof_scope_, __LINE__)(PROF_CONCAT(prof_ctr_, __LINE__), (size_t)(limbs))
+
+#else
+
+#define PROF_SCOPE(name, limbs) do {} while (0)
+
+#endif
+
+#endif